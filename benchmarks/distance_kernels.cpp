@@ -0,0 +1,107 @@
+// Throughput of the scalar & vectorized distance kernels on vertex sets from
+// 1k to 1M points, build with -DBUILD_BENCHMARKS=ON (and -DENABLE_AVX2=ON).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "States/Algorithms/SamplingBased/DistanceKernels.h"
+
+using namespace path_finding_visualizer::sampling_based;
+
+namespace {
+
+template <typename F>
+double pointsPerSecond(std::size_t n, std::size_t no_of_queries, F &&f) {
+  const auto t0 = std::chrono::steady_clock::now();
+  for (std::size_t q = 0u; q < no_of_queries; ++q) f(q);
+  const double s = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - t0)
+                       .count();
+  return static_cast<double>(n) * no_of_queries / s;
+}
+
+}  // namespace
+
+int main() {
+  std::mt19937 rn_gen(42u);
+  std::uniform_real_distribution<> dis(0, 1);
+
+  std::printf("kernels: %s\n", distanceKernelName());
+  std::printf("%8s %-8s %14s %14s %8s\n", "points", "kernel", "scalar pts/s",
+              "simd pts/s", "speedup");
+
+  for (std::size_t n = 1000u; n <= 1000000u; n *= 10u) {
+    std::vector<double> xs(n), ys(n);
+    std::vector<std::uint32_t> ids(n);
+    for (std::size_t i = 0u; i < n; ++i) {
+      xs[i] = dis(rn_gen);
+      ys[i] = dis(rn_gen);
+      ids[i] = static_cast<std::uint32_t>(i);
+    }
+    std::vector<double> qx(256u), qy(256u);
+    for (std::size_t q = 0u; q < qx.size(); ++q) {
+      qx[q] = dis(rn_gen);
+      qy[q] = dis(rn_gen);
+    }
+    // roughly the same work per row
+    const std::size_t no_of_queries = std::max<std::size_t>(20000000u / n, 4u);
+
+    // both kernels must agree before they are timed
+    for (std::size_t q = 0u; q < qx.size(); ++q) {
+      double d1 = std::numeric_limits<double>::infinity(), d2 = d1;
+      std::vector<std::uint32_t> v1, v2;
+      withinRadiusScalar(xs.data(), ys.data(), ids.data(), n, qx[q], qy[q],
+                         0.01, v1);
+      withinRadius(xs.data(), ys.data(), ids.data(), n, qx[q], qy[q], 0.01,
+                   v2);
+      if (argminSquaredDistanceScalar(xs.data(), ys.data(), n, qx[q], qy[q],
+                                      d1) !=
+              argminSquaredDistance(xs.data(), ys.data(), n, qx[q], qy[q],
+                                    d2) ||
+          v1 != v2) {
+        std::printf("kernels disagree at %zu points\n", n);
+        return 1;
+      }
+    }
+
+    std::size_t sink = 0u;
+    std::vector<std::uint32_t> out;
+    const double argmin_scalar =
+        pointsPerSecond(n, no_of_queries, [&](std::size_t q) {
+          double d = std::numeric_limits<double>::infinity();
+          sink += argminSquaredDistanceScalar(xs.data(), ys.data(), n,
+                                              qx[q % 256u], qy[q % 256u], d);
+        });
+    const double argmin_simd =
+        pointsPerSecond(n, no_of_queries, [&](std::size_t q) {
+          double d = std::numeric_limits<double>::infinity();
+          sink += argminSquaredDistance(xs.data(), ys.data(), n, qx[q % 256u],
+                                        qy[q % 256u], d);
+        });
+    const double radius_scalar =
+        pointsPerSecond(n, no_of_queries, [&](std::size_t q) {
+          out.clear();
+          withinRadiusScalar(xs.data(), ys.data(), ids.data(), n,
+                             qx[q % 256u], qy[q % 256u], 0.01, out);
+          sink += out.size();
+        });
+    const double radius_simd =
+        pointsPerSecond(n, no_of_queries, [&](std::size_t q) {
+          out.clear();
+          withinRadius(xs.data(), ys.data(), ids.data(), n, qx[q % 256u],
+                       qy[q % 256u], 0.01, out);
+          sink += out.size();
+        });
+
+    std::printf("%8zu %-8s %14.3e %14.3e %7.2fx\n", n, "nearest",
+                argmin_scalar, argmin_simd, argmin_simd / argmin_scalar);
+    std::printf("%8zu %-8s %14.3e %14.3e %7.2fx\n", n, "radius",
+                radius_scalar, radius_simd, radius_simd / radius_scalar);
+    if (sink == 0u) std::printf(" ");
+  }
+  return 0;
+}
@@ -10,14 +10,23 @@
 #include <vector>
 
 #include "State.h"
+#include "ThreadPool.h"
 
 namespace path_finding_visualizer {
 
 static const std::vector<std::string> GRAPH_BASED_PLANNERS{"BFS", "DFS",
                                                            "DIJKSTRA", "A*"};
-static const std::vector<std::string> SAMPLING_BASED_PLANNERS{"RRT", "RRT*"};
+static const std::vector<std::string> SAMPLING_BASED_PLANNERS{
+    "RRT", "RRT*", "RRT-Connect", "Informed RRT*", "PRM*", "BIT*"};
 enum GRAPH_BASED_PLANNERS_IDS { BFS, DFS, DIJKSTRA, AStar };
-enum SAMPLING_BASED_PLANNERS_IDS { RRT, RRT_STAR };
+enum SAMPLING_BASED_PLANNERS_IDS {
+  RRT,
+  RRT_STAR,
+  RRT_CONNECT,
+  INFORMED_RRT_STAR,
+  PRM_STAR,
+  BIT_STAR
+};
 
 class Game {
  public:
@@ -47,10 +56,19 @@ class Game {
   sf::RenderWindow* window_;
   sf::RenderTexture* render_texture_;
   sf::Vector2f view_move_xy_;
+  // planning scene units per screen pixel
+  float view_zoom_;
+  // planning scene render target size & what was last drawn into it
+  sf::Vector2u scene_size_;
+  sf::View scene_view_;
+  std::uint64_t scene_revision_;
+  bool scene_dirty_;
   ImVec2 mouse_pos_in_canvas_;
   sf::Event ev_;
   sf::Clock dtClock_;
   float dt_;
+  // shared by all planners, declared before the states so it outlives them
+  std::shared_ptr<ThreadPool> thread_pool_;
   std::stack<std::unique_ptr<State>> states_;
   std::string curr_planner_;
   std::shared_ptr<gui::LoggerPanel> logger_panel_;
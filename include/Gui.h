@@ -130,5 +130,15 @@ inline bool inputDouble(const std::string& label, double* val,
   return is_active;
 }
 
+inline bool checkbox(const std::string& label, bool* val,
+                     const std::string& help_marker = "") {
+  bool is_changed = ImGui::Checkbox(label.c_str(), val);
+  if (!help_marker.empty()) {
+    ImGui::SameLine();
+    HelpMarker(help_marker.c_str());
+  }
+  return is_changed;
+}
+
 }  // namespace gui
 }  // namespace path_finding_visualizer
\ No newline at end of file
@@ -23,6 +23,16 @@ class MessageQueue {
                  // C++
   };
 
+  bool tryReceive(T &msg) {
+    // non-blocking receive, returns false if the queue is empty
+    std::lock_guard<std::mutex> uLock(mutex_);
+    if (messages_.empty()) return false;
+
+    msg = std::move(messages_.front());
+    messages_.pop();
+    return true;
+  };
+
   void send(T &&msg) {
     // perform vector modification under the lock
     std::lock_guard<std::mutex> uLock(mutex_);
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "ThreadPool.h"
+
+namespace path_finding_visualizer {
+
+/**
+ * @brief Point of a path in the coordinates of its planner
+ */
+struct PathPoint {
+  double x, y;
+};
+
+/**
+ * @brief Outcome of a PathSmoother run
+ */
+struct SmoothingStats {
+  double initial_cost{0.0};
+  double shortcut_cost{0.0};
+  double final_cost{0.0};
+  double time_ms{0.0};
+  std::size_t no_of_shortcuts{0u};
+  std::size_t no_of_collision_checks{0u};
+  // true if the time budget ran out before both stages were done
+  bool budget_exceeded{false};
+};
+
+/**
+ * @brief Shortens & smooths planned paths
+ * Random shortcuts are proposed in rounds. Their collision checks run in
+ * parallel on the thread pool and the non-overlapping valid ones that save
+ * the most are applied. The shortcut polyline is then turned into a uniform
+ * cubic B-spline. Spline pieces that collide are pulled back onto the
+ * polyline by tripling their control points, so the curve only leaves the
+ * polyline where it is known to be free.
+ */
+class PathSmoother {
+ public:
+  /**
+   * @brief Returns true if the straight segment between two points is
+   * collision free, called concurrently by the pool workers
+   */
+  using SegmentCheck =
+      std::function<bool(const PathPoint &, const PathPoint &)>;
+
+  explicit PathSmoother(std::shared_ptr<ThreadPool> thread_pool);
+
+  /**
+   * @brief Shortcut & smooth a path within a time budget
+   * @param path Polyline from start to goal, replaced by the result
+   * @param resolution Spacing of the points sampled along the spline
+   * @param spline false stops after the shortcuts
+   * @param seed Seed of the shortcut proposals
+   */
+  SmoothingStats smooth(std::vector<PathPoint> &path,
+                        const SegmentCheck &is_free, double resolution,
+                        double time_budget_ms, bool spline,
+                        std::uint32_t seed) const;
+
+  static double length(const std::vector<PathPoint> &path);
+
+ private:
+  std::shared_ptr<ThreadPool> thread_pool_;
+};
+
+}  // namespace path_finding_visualizer
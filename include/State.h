@@ -12,6 +12,9 @@
 #include <vector>
 
 #include "Gui.h"
+#include "PathSmoother.h"
+#include "ThreadPool.h"
+#include "Trace.h"
 
 /*
   State Base Class
@@ -23,28 +26,88 @@ class State {
  private:
  protected:
   std::shared_ptr<gui::LoggerPanel> logger_panel_;
+  // application-wide pool running the planning jobs
+  std::shared_ptr<ThreadPool> thread_pool_;
   sf::Vector2f mousePositionWindow_;
   bool is_reset_;
   bool is_running_;
 
+  // planner events recorded by the solver thread & replayed by the UI
+  Trace trace_;
+  std::size_t replay_cursor_;
+  double replay_budget_;
+  float replay_speed_;  // events per second
+  bool replay_paused_;
+  char trace_filename_[256];
+
+  // bumped whenever the planning scene needs to be redrawn
+  std::uint64_t scene_revision_;
+  void markSceneChanged() { ++scene_revision_; }
+
+  // path post-processing shared by the planner families
+  PathSmoother path_smoother_;
+  bool smooth_path_;
+  bool smooth_spline_;
+  double smoothing_budget_ms_;
+  // written by the solver before it reports, read by the UI once solved
+  std::vector<PathPoint> smoothed_path_;
+  SmoothingStats smoothing_stats_;
+
+  // clear the recorded trace and the replayed planner state
+  void resetTrace();
+  // move the replay cursor to a particular event
+  void seekReplay(std::size_t target);
+
+  // shortcut & smooth a solution path into smoothed_path_
+  void smoothPath(std::vector<PathPoint> path,
+                  const PathSmoother::SegmentCheck &is_free, double resolution,
+                  std::uint32_t seed);
+  // post-processing parameters & results
+  void renderSmoothingGui();
+  void renderSmoothingStats();
+  void logSmoothing();
+
  public:
   // Constructor
-  State(std::shared_ptr<gui::LoggerPanel> logger_panel);
+  State(std::shared_ptr<gui::LoggerPanel> logger_panel,
+        std::shared_ptr<ThreadPool> thread_pool);
 
   // Destructor
   virtual ~State();
 
   void setReset(bool is_reset) { is_reset_ = is_reset; }
   void setRunning(bool is_running) { is_running_ = is_running; }
+  std::uint64_t sceneRevision() const { return scene_revision_; }
 
   // Functions
   void updateMousePosition(const ImVec2 &mousePos);
+  void updateReplay(const float &dt);
+  void renderReplayGui();
+
+  // render planner statistics into the stats panel
+  virtual void renderStats();
 
   // virtual functions
   virtual void endState() = 0;
   virtual void update(const float &dt, const ImVec2 &mousePos) = 0;
   virtual void renderConfig() = 0;
   virtual void renderScene(sf::RenderTexture &render_texture) = 0;
+
+  // replay functions
+  // clear the planner state shown in the planning scene
+  virtual void resetReplay() = 0;
+  // apply a recorded planner event to the planner state shown in the scene
+  virtual void applyTraceEvent(const TraceEvent &e) = 0;
+
+  // planners returning true write the replayed planner state, i.e. the
+  // state after the first replay_cursor_ events, through exportReplay()
+  virtual bool supportsReplayExport() const { return false; }
+  virtual bool exportReplay(const std::string &filename) const {
+    return false;
+  }
+
+  // false while the state cannot start planning, e.g. during a benchmark
+  virtual bool canRun() const { return true; }
 };
 
 }  // namespace path_finding_visualizer
\ No newline at end of file
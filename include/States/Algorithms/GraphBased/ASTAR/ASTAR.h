@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <queue>
 
 #include "States/Algorithms/GraphBased/BFS/BFS.h"
@@ -8,20 +9,11 @@
 namespace path_finding_visualizer {
 namespace graph_based {
 
-// custom function for returning minimum distance node
-// to be used in priority queue
-struct MinimumDistanceASTAR {
-  // operator overloading
-  bool operator()(const std::shared_ptr<Node> &n1,
-                  const std::shared_ptr<Node> &n2) const {
-    return n1->getFDistance() > n2->getFDistance();
-  }
-};
-
 class ASTAR : public BFS {
  public:
   // Constructor
-  ASTAR(std::shared_ptr<gui::LoggerPanel> logger_panel);
+  ASTAR(std::shared_ptr<gui::LoggerPanel> logger_panel,
+        std::shared_ptr<ThreadPool> thread_pool);
 
   // Destructor
   virtual ~ASTAR();
@@ -30,13 +22,13 @@ class ASTAR : public BFS {
   virtual void initAlgorithm() override;
 
   // override main update function
-  virtual void updatePlanner(bool &solved, Node &start_node,
-                             Node &end_node) override;
+  virtual void updatePlanner(bool &solved, CellIndex start_cell,
+                             CellIndex goal_cell) override;
 
  protected:
   // ASTAR related
-  std::priority_queue<std::shared_ptr<Node>, std::vector<std::shared_ptr<Node>>,
-                      MinimumDistanceASTAR>
+  std::priority_queue<PriorityCell, std::vector<PriorityCell>,
+                      std::greater<PriorityCell>>
       frontier_;
 
   bool use_manhattan_heuristics_{true};
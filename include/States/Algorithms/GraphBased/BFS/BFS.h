@@ -3,7 +3,6 @@
 #include <queue>
 
 #include "GraphBased.h"
-#include "Node.h"
 
 namespace path_finding_visualizer {
 namespace graph_based {
@@ -11,7 +10,8 @@ namespace graph_based {
 class BFS : public GraphBased {
  public:
   // Constructor
-  BFS(std::shared_ptr<gui::LoggerPanel> logger_panel);
+  BFS(std::shared_ptr<gui::LoggerPanel> logger_panel,
+      std::shared_ptr<ThreadPool> thread_pool);
 
   // Destructor
   virtual ~BFS();
@@ -27,12 +27,12 @@ class BFS : public GraphBased {
   virtual void renderParametersGui() override;
 
   // override main update function
-  virtual void updatePlanner(bool &solved, Node &start_node,
-                             Node &end_node) override;
+  virtual void updatePlanner(bool &solved, CellIndex start_cell,
+                             CellIndex goal_cell) override;
 
  private:
   // BFS related
-  std::queue<std::shared_ptr<Node>> frontier_;
+  std::queue<CellIndex> frontier_;
 };
 
 }  // namespace graph_based
@@ -10,7 +10,8 @@ namespace graph_based {
 class DFS : public BFS {
  public:
   // Constructor
-  DFS(std::shared_ptr<gui::LoggerPanel> logger_panel);
+  DFS(std::shared_ptr<gui::LoggerPanel> logger_panel,
+      std::shared_ptr<ThreadPool> thread_pool);
 
   // Destructor
   virtual ~DFS();
@@ -19,12 +20,12 @@ class DFS : public BFS {
   void initAlgorithm() override;
 
   // override main update function
-  virtual void updatePlanner(bool &solved, Node &start_node,
-                             Node &end_node) override;
+  virtual void updatePlanner(bool &solved, CellIndex start_cell,
+                             CellIndex goal_cell) override;
 
  private:
   // DFS related
-  std::stack<std::shared_ptr<Node>> frontier_;
+  std::stack<CellIndex> frontier_;
 };
 
 }  // namespace graph_based
@@ -8,21 +8,56 @@
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <utility>
 #include <vector>
 
 #include "Gui.h"
 #include "MessageQueue.h"
 #include "State.h"
-#include "States/Algorithms/GraphBased/Node.h"
+#include "States/Algorithms/GraphBased/GridLod.h"
+#include "States/Algorithms/GraphBased/TiledGrid.h"
 #include "States/Algorithms/GraphBased/Utils.h"
 
 namespace path_finding_visualizer {
 namespace graph_based {
 
+// cell ids are 32 bits wide, so rows * cols must stay below 2^32
+static constexpr int MAX_GRID_DIM = 50000;
+
+// row-major index of a grid cell
+using CellIndex = std::uint32_t;
+
+// frontier entry of priority-based planners, ordered by priority
+using PriorityCell = std::pair<float, CellIndex>;
+
+// search state of a cell (solver thread)
+struct SearchCell {
+  float g{INFINITY};
+  float f{INFINITY};
+  CellIndex parent{Trace::NO_PARENT};
+  bool visited{false};
+};
+
+// replayed search state of a cell (UI thread)
+enum CELL_STATE : std::uint8_t { CELL_IDLE, CELL_FRONTIER, CELL_VISITED };
+struct ReplayCell {
+  CellIndex parent{Trace::NO_PARENT};
+  std::uint8_t state{CELL_IDLE};
+};
+
+// display codes of the rendered gridmap, higher codes win in the LOD levels
+enum DISPLAY_CODE : std::uint8_t {
+  DISPLAY_IDLE,
+  DISPLAY_VISITED,
+  DISPLAY_FRONTIER,
+  DISPLAY_OBSTACLE
+};
+
 class GraphBased : public State {
  public:
   // Constructor
-  GraphBased(std::shared_ptr<gui::LoggerPanel> logger_panel);
+  GraphBased(std::shared_ptr<gui::LoggerPanel> logger_panel,
+             std::shared_ptr<ThreadPool> thread_pool);
 
   // Destructor
   virtual ~GraphBased();
@@ -32,6 +67,9 @@ class GraphBased : public State {
   void update(const float& dt, const ImVec2& mousePos) override;
   void renderConfig() override;
   void renderScene(sf::RenderTexture& render_texture) override;
+  void resetReplay() override;
+  void applyTraceEvent(const TraceEvent& e) override;
+  void renderStats() override;
 
   // virtual functions
   virtual void clearObstacles();
@@ -42,11 +80,10 @@ class GraphBased : public State {
   virtual void updateNodes() = 0;
   virtual void initAlgorithm() = 0;
   // pure virtual function need to be implemented by graph-based planners
-  virtual void updatePlanner(bool& solved, Node& node_start,
-                             Node& node_end) = 0;
+  virtual void updatePlanner(bool& solved, CellIndex start_cell,
+                             CellIndex goal_cell) = 0;
 
-  void solveConcurrently(std::shared_ptr<Node> nodeStart,
-                         std::shared_ptr<Node> nodeEnd,
+  void solveConcurrently(CellIndex start_cell, CellIndex goal_cell,
                          std::shared_ptr<MessageQueue<bool>> message_queue);
   void updateKeyTime(const float& dt);
   const bool getKeyTime();
@@ -56,11 +93,30 @@ class GraphBased : public State {
   void initColors();
   void initVariables();
   void initGridMapParams();
-  void initNodes(bool reset = true, bool reset_neighbours_only = false);
+  void initGrid(bool reset = true);
+
+  // cell helpers
+  CellIndex cellIndex(const sf::Vector2i& pos) const;
+  sf::Vector2i cellPos(CellIndex idx) const;
+  bool isObstacle(const sf::Vector2i& pos) const;
+  // true if no obstacle cell is crossed, points are in cell units
+  bool isSegmentFree(const PathPoint& a, const PathPoint& b) const;
+  int findNeighbours(const sf::Vector2i& pos, sf::Vector2i* neighbours) const;
+
+  // render helpers
+  std::uint8_t displayCode(int row, int col) const;
+  const sf::Color& displayColor(std::uint8_t code) const;
+
+  // trace recording functions (solver thread)
+  void recordExpand(CellIndex cell);
+  void recordFrontier(CellIndex cell, CellIndex parent);
+
+  // post-process the searched path into smoothed_path_ (solver thread)
+  void smoothSolution(CellIndex start_cell, CellIndex goal_cell);
 
   // colors
   sf::Color BGN_COL, FONT_COL, IDLE_COL, HOVER_COL, ACTIVE_COL, START_COL,
-      END_COL, VISITED_COL, FRONTIER_COL, OBST_COL, PATH_COL;
+      END_COL, VISITED_COL, FRONTIER_COL, OBST_COL, PATH_COL, SMOOTH_PATH_COL;
 
   // key timers
   float keyTime_;
@@ -79,9 +135,17 @@ class GraphBased : public State {
 
   // Algorithm related
   std::string algo_name_;
-  std::vector<std::shared_ptr<Node>> nodes_;
-  std::shared_ptr<Node> nodeStart_;
-  std::shared_ptr<Node> nodeEnd_;
+  // the gridmap is stored in lazily allocated tiles
+  // obstacles are edited by the UI, search state is owned by the solver
+  TiledGrid<std::uint8_t> obstacles_;
+  TiledGrid<SearchCell> search_;
+  TiledGrid<ReplayCell> replay_;
+  // downsampled display codes for rendering zoomed out gridmaps
+  GridLod lod_;
+  // batched quads of the planning scene, reused across frames
+  sf::VertexArray scene_vertices_;
+  CellIndex start_cell_;
+  CellIndex goal_cell_;
 
   // MessageQueue Object
   std::shared_ptr<MessageQueue<bool>> message_queue_;
@@ -89,12 +153,13 @@ class GraphBased : public State {
   // logic flags
   bool is_initialized_;
   bool is_solved_;
+  bool is_stopped_;
   bool disable_run_;
   bool disable_gui_parameters_;
 
-  // threads
-  std::thread t_;
-  bool thread_joined_;
+  // planning job running on the thread pool & mutex
+  std::future<void> solver_;
+  std::mutex mutex_;
 };
 
 }  // namespace graph_based
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "States/Algorithms/GraphBased/TiledGrid.h"
+
+namespace path_finding_visualizer {
+namespace graph_based {
+
+/**
+ * @brief Downsampled levels of a gridmap of display codes
+ * A block at level l covers 2^l x 2^l cells and holds the largest code of
+ * its cells, so higher codes win when several cells fall into one pixel.
+ * Levels inside a tile are stored per touched tile, levels above the tile
+ * size form a dense pyramid over the tile summaries. Tiles are marked dirty
+ * on edits and rebuilt on the next refresh().
+ */
+class GridLod {
+ public:
+  static constexpr int TILE_BITS = TiledGrid<std::uint8_t>::TILE_BITS;
+  static constexpr int TILE_SIZE = 1 << TILE_BITS;
+
+  /**
+   * @brief Set the grid dimensions, all blocks are reset to zero
+   */
+  void resize(int rows, int cols) {
+    rows_ = rows;
+    cols_ = cols;
+    tile_rows_ = (rows + TILE_SIZE - 1) >> TILE_BITS;
+    tile_cols_ = (cols + TILE_SIZE - 1) >> TILE_BITS;
+    const std::size_t no_of_tiles =
+        static_cast<std::size_t>(tile_rows_) * tile_cols_;
+    tile_mips_.clear();
+    tile_mips_.resize(no_of_tiles);
+    is_dirty_.assign(no_of_tiles, 0u);
+    dirty_tiles_.clear();
+
+    // pyramid over the tiles, down to a single block
+    upper_.clear();
+    upper_dims_.clear();
+    int r = tile_rows_, c = tile_cols_;
+    while (true) {
+      upper_.emplace_back(static_cast<std::size_t>(r) * c, 0u);
+      upper_dims_.emplace_back(r, c);
+      if (r <= 1 && c <= 1) break;
+      r = (r + 1) / 2;
+      c = (c + 1) / 2;
+    }
+    upper_dirty_ = false;
+  }
+
+  /**
+   * @brief Mark the tile containing the cell for rebuilding
+   */
+  void markDirty(int row, int col) {
+    markTileDirty(static_cast<std::size_t>(row >> TILE_BITS) * tile_cols_ +
+                  (col >> TILE_BITS));
+  }
+
+  /**
+   * @brief Mark every tile holding non-zero blocks for rebuilding
+   */
+  void markAllDirty() {
+    for (std::size_t t = 0u; t < tile_mips_.size(); ++t) {
+      if (tile_mips_[t]) markTileDirty(t);
+    }
+  }
+
+  /**
+   * @brief Rebuild the dirty tiles and the pyramid above them
+   * @param cell_value Callable returning the display code of (row, col)
+   */
+  template <typename F>
+  void refresh(const F& cell_value) {
+    for (const std::size_t t : dirty_tiles_) {
+      rebuildTile(t, cell_value);
+      is_dirty_[t] = 0u;
+    }
+    dirty_tiles_.clear();
+
+    if (!upper_dirty_) return;
+    for (std::size_t l = 1u; l < upper_.size(); ++l) {
+      const int src_rows = upper_dims_[l - 1].first;
+      const int src_cols = upper_dims_[l - 1].second;
+      const int cols = upper_dims_[l].second;
+      for (int r = 0; r < upper_dims_[l].first; ++r) {
+        for (int c = 0; c < cols; ++c) {
+          std::uint8_t v = 0u;
+          for (int dr = 0; dr < 2; ++dr) {
+            for (int dc = 0; dc < 2; ++dc) {
+              const int sr = 2 * r + dr, sc = 2 * c + dc;
+              if (sr < src_rows && sc < src_cols) {
+                v = std::max(v, upper_[l - 1][static_cast<std::size_t>(sr) *
+                                                  src_cols +
+                                              sc]);
+              }
+            }
+          }
+          upper_[l][static_cast<std::size_t>(r) * cols + c] = v;
+        }
+      }
+    }
+    upper_dirty_ = false;
+  }
+
+  /**
+   * @brief Largest code in a block, valid after refresh()
+   * @param level Block level, 1 <= level <= maxLevel()
+   * @param row Block row, i.e. cell row >> level
+   * @param col Block column, i.e. cell column >> level
+   */
+  std::uint8_t block(int level, int row, int col) const {
+    if (level >= TILE_BITS) {
+      const std::size_t l = static_cast<std::size_t>(level - TILE_BITS);
+      return upper_[l][static_cast<std::size_t>(row) * upper_dims_[l].second +
+                       col];
+    }
+
+    const int shift = TILE_BITS - level;
+    const std::uint8_t* mip =
+        tile_mips_[static_cast<std::size_t>(row >> shift) * tile_cols_ +
+                   (col >> shift)]
+            .get();
+    if (!mip) return 0u;
+
+    const int side = TILE_SIZE >> level;
+    return mip[levelOffset(level) +
+               static_cast<std::size_t>(row & (side - 1)) * side +
+               (col & (side - 1))];
+  }
+
+  int maxLevel() const {
+    return TILE_BITS + static_cast<int>(upper_.size()) - 1;
+  }
+
+ private:
+  // bytes of levels 1 .. TILE_BITS in a tile mip chain
+  static constexpr std::size_t MIP_BYTES = (TILE_SIZE * TILE_SIZE - 1) / 3;
+
+  static std::size_t levelOffset(int level) {
+    std::size_t offset = 0u;
+    for (int l = 1; l < level; ++l) {
+      const std::size_t side = static_cast<std::size_t>(TILE_SIZE >> l);
+      offset += side * side;
+    }
+    return offset;
+  }
+
+  void markTileDirty(std::size_t t) {
+    if (is_dirty_[t]) return;
+    is_dirty_[t] = 1u;
+    dirty_tiles_.push_back(t);
+  }
+
+  template <typename F>
+  void rebuildTile(std::size_t t, const F& cell_value) {
+    if (!tile_mips_[t]) tile_mips_[t].reset(new std::uint8_t[MIP_BYTES]);
+    std::uint8_t* mip = tile_mips_[t].get();
+
+    // level 1 from the cells, clipped to the grid border
+    const int row0 = static_cast<int>(t / tile_cols_) << TILE_BITS;
+    const int col0 = static_cast<int>(t % tile_cols_) << TILE_BITS;
+    const int half = TILE_SIZE / 2;
+    for (int r = 0; r < half; ++r) {
+      for (int c = 0; c < half; ++c) {
+        std::uint8_t v = 0u;
+        for (int dr = 0; dr < 2; ++dr) {
+          for (int dc = 0; dc < 2; ++dc) {
+            const int row = row0 + 2 * r + dr, col = col0 + 2 * c + dc;
+            if (row < rows_ && col < cols_) {
+              v = std::max(v, static_cast<std::uint8_t>(cell_value(row, col)));
+            }
+          }
+        }
+        mip[r * half + c] = v;
+      }
+    }
+
+    // remaining levels from the level below
+    for (int l = 2; l <= TILE_BITS; ++l) {
+      const std::uint8_t* src = mip + levelOffset(l - 1);
+      std::uint8_t* dst = mip + levelOffset(l);
+      const int side = TILE_SIZE >> l;
+      for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+          const std::uint8_t* top = src + (2 * r) * (2 * side) + 2 * c;
+          const std::uint8_t* bottom = top + 2 * side;
+          dst[r * side + c] = std::max(std::max(top[0], top[1]),
+                                       std::max(bottom[0], bottom[1]));
+        }
+      }
+    }
+
+    // tile summary feeds the pyramid above the tiles
+    const std::uint8_t summary = mip[levelOffset(TILE_BITS)];
+    if (upper_[0][t] != summary) {
+      upper_[0][t] = summary;
+      upper_dirty_ = true;
+    }
+  }
+
+  int rows_{0};
+  int cols_{0};
+  int tile_rows_{0};
+  int tile_cols_{0};
+  // mip chain of each tile, null while every block of the tile is zero
+  std::vector<std::unique_ptr<std::uint8_t[]>> tile_mips_;
+  std::vector<std::uint8_t> is_dirty_;
+  std::vector<std::size_t> dirty_tiles_;
+  // levels TILE_BITS and above, dense over the tile grid
+  std::vector<std::vector<std::uint8_t>> upper_;
+  std::vector<std::pair<int, int>> upper_dims_;
+  bool upper_dirty_{false};
+};
+
+}  // namespace graph_based
+}  // namespace path_finding_visualizer
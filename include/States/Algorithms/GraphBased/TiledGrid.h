@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace path_finding_visualizer {
+namespace graph_based {
+
+/**
+ * @brief 2D grid stored in fixed-size square tiles allocated lazily
+ * Untouched tiles all point to one shared read-only tile holding the default
+ * value, so memory grows with the touched area instead of the map size.
+ * get() never allocates, at() allocates the tile on first write access.
+ */
+template <typename T>
+class TiledGrid {
+ public:
+  static constexpr int TILE_BITS = 6;
+  static constexpr int TILE_SIZE = 1 << TILE_BITS;
+  static constexpr int TILE_MASK = TILE_SIZE - 1;
+  static constexpr std::size_t TILE_CELLS =
+      static_cast<std::size_t>(TILE_SIZE) * TILE_SIZE;
+
+  explicit TiledGrid(const T& default_value = T())
+      : default_tile_{new T[TILE_CELLS]} {
+    std::fill(default_tile_.get(), default_tile_.get() + TILE_CELLS,
+              default_value);
+  }
+
+  /**
+   * @brief Set the grid dimensions, all cells are reset to default
+   */
+  void resize(int rows, int cols) {
+    rows_ = rows;
+    cols_ = cols;
+    tile_rows_ = (rows + TILE_MASK) >> TILE_BITS;
+    tile_cols_ = (cols + TILE_MASK) >> TILE_BITS;
+    const std::size_t no_of_tiles =
+        static_cast<std::size_t>(tile_rows_) * tile_cols_;
+    tiles_.clear();
+    tiles_.resize(no_of_tiles);
+    directory_.assign(no_of_tiles, default_tile_.get());
+    allocated_tiles_ = 0u;
+  }
+
+  /**
+   * @brief Reset all cells to default and release every allocated tile
+   */
+  void reset() {
+    if (allocated_tiles_ == 0u) return;
+    for (std::size_t t = 0u; t < tiles_.size(); ++t) {
+      if (tiles_[t]) {
+        tiles_[t].reset();
+        directory_[t] = default_tile_.get();
+      }
+    }
+    allocated_tiles_ = 0u;
+  }
+
+  const T& get(int row, int col) const {
+    return directory_[tileIndex(row, col)][cellOffset(row, col)];
+  }
+
+  T& at(int row, int col) {
+    const std::size_t t = tileIndex(row, col);
+    if (!tiles_[t]) allocate(t);
+    return directory_[t][cellOffset(row, col)];
+  }
+
+  /**
+   * @brief Whether the tile containing the cell has been allocated
+   */
+  bool isTouched(int row, int col) const {
+    return static_cast<bool>(tiles_[tileIndex(row, col)]);
+  }
+
+  int rows() const { return rows_; }
+  int cols() const { return cols_; }
+  std::size_t allocatedTiles() const { return allocated_tiles_; }
+
+  /**
+   * @brief Memory used by the tiles & the tile directory in bytes
+   */
+  std::size_t bytes() const {
+    return (allocated_tiles_ + 1u) * TILE_CELLS * sizeof(T) +
+           tiles_.size() * (sizeof(T*) + sizeof(std::unique_ptr<T[]>));
+  }
+
+ private:
+  std::size_t tileIndex(int row, int col) const {
+    return static_cast<std::size_t>(row >> TILE_BITS) * tile_cols_ +
+           (col >> TILE_BITS);
+  }
+
+  static std::size_t cellOffset(int row, int col) {
+    return (static_cast<std::size_t>(row & TILE_MASK) << TILE_BITS) |
+           static_cast<std::size_t>(col & TILE_MASK);
+  }
+
+  void allocate(std::size_t t) {
+    tiles_[t].reset(new T[TILE_CELLS]);
+    std::copy(default_tile_.get(), default_tile_.get() + TILE_CELLS,
+              tiles_[t].get());
+    directory_[t] = tiles_[t].get();
+    ++allocated_tiles_;
+  }
+
+  int rows_{0};
+  int cols_{0};
+  int tile_rows_{0};
+  int tile_cols_{0};
+  // shared read-only tile for untouched space
+  std::unique_ptr<T[]> default_tile_;
+  // owned tiles, null while the tile is untouched
+  std::vector<std::unique_ptr<T[]>> tiles_;
+  // tile lookup, points either to an owned tile or to the default tile
+  std::vector<T*> directory_;
+  std::size_t allocated_tiles_{0u};
+};
+
+}  // namespace graph_based
+}  // namespace path_finding_visualizer
@@ -1,119 +1,54 @@
 #pragma once
 
+#include <SFML/System.hpp>
 #include <cmath>
 
-#include "States/Algorithms/GraphBased/Node.h"
-
 namespace path_finding_visualizer {
 namespace graph_based {
 namespace utils {
 
-inline double distanceCost(const Node &n1, const Node &n2) {
-  return std::sqrt(
-      (n1.getPos().x - n2.getPos().x) * (n1.getPos().x - n2.getPos().x) +
-      (n1.getPos().y - n2.getPos().y) * (n1.getPos().y - n2.getPos().y));
+// cell positions are (row, col) pairs stored as sf::Vector2i(x = row, y = col)
+
+inline double distanceCost(const sf::Vector2i &p1, const sf::Vector2i &p2) {
+  const double dx = p1.x - p2.x;
+  const double dy = p1.y - p2.y;
+  return std::sqrt(dx * dx + dy * dy);
 }
 
-inline double costToGoHeuristics(const Node &n1, const Node &n2,
+inline double costToGoHeuristics(const sf::Vector2i &p1, const sf::Vector2i &p2,
                                  bool use_manhattan = false) {
-  if (use_manhattan)
-    return fabs(n1.getPos().x - n2.getPos().x) +
-           fabs(n1.getPos().y - n2.getPos().y);
+  const double dx = p1.x - p2.x;
+  const double dy = p1.y - p2.y;
+  if (use_manhattan) return std::fabs(dx) + std::fabs(dy);
 
-  return std::sqrt(
-      (n1.getPos().x - n2.getPos().x) * (n1.getPos().x - n2.getPos().x) +
-      (n1.getPos().y - n2.getPos().y) * (n1.getPos().y - n2.getPos().y));
+  return std::sqrt(dx * dx + dy * dy);
 }
 
-inline void addNeighbours(std::vector<std::shared_ptr<Node>> &nodes,
-                          const unsigned int node_idx, const unsigned int width,
-                          const unsigned int height,
+/**
+ * @brief Find the neighbours of a cell in a rows x cols grid
+ * Neighbours are ordered as top, bottom, right, top-right, bottom-right,
+ * left, top-left and bottom-left, diagonals only for 8-connectivity.
+ * @param neighbours Output array with room for 8 cells
+ * @return Number of neighbours found
+ */
+inline int findNeighbours(const sf::Vector2i &pos, const int rows,
+                          const int cols, sf::Vector2i *neighbours,
                           bool use_eight_connectivity = false) {
-  // TODO: Add error handling here
-
-  // setup
-  const int size = width * height;
-  const int cell_minus_width = node_idx - width;
-  const int cell_plus_width = node_idx + width;
-  const int cell_mod_width = node_idx % width;
-  const int top_right = width - 1;
-
-  unsigned int top_idx, bottom_idx;
-
-  // if not at top-edge and bottom-edge, we add both top and bottom neighbours
-  if (cell_minus_width >= 0 && cell_plus_width < size) {
-    top_idx = cell_minus_width;
-    bottom_idx = cell_plus_width;
-    nodes[node_idx]->setNeighbours(nodes[top_idx]);
-    nodes[node_idx]->setNeighbours(nodes[bottom_idx]);
-  }
-  // otherwise, it can be at either top-edge or bottom-edge
-  else {
-    // if at top-edge, only add bottom neighbour
-    if (cell_minus_width < 0) {
-      bottom_idx = cell_plus_width;
-      nodes[node_idx]->setNeighbours(nodes[bottom_idx]);
-    }
-    // otherwise, add top neighbour
-    else {
-      top_idx = cell_minus_width;
-      nodes[node_idx]->setNeighbours(nodes[top_idx]);
-    }
-  }
-
-  // if the cell is not at the right-edge of 2D grid,
-  // we find all the right, top-right and bottom-right neighbours
-  if (cell_mod_width != top_right) {
-    nodes[node_idx]->setNeighbours(nodes[node_idx + 1]);  // right neighbour
-
-    if (use_eight_connectivity) {
-      // now find if node is at top edge or bottom edge or otherwise
-      if (cell_minus_width < 0) {  // if at top-edge
-        nodes[node_idx]->setNeighbours(
-            nodes[bottom_idx + 1]);  // bottom-right neighbour
-      }
-      // if at bottom-edge
-      else if (cell_plus_width >= size) {
-        nodes[node_idx]->setNeighbours(
-            nodes[top_idx + 1]);  // top-right neighbour
-      }
-      // otherwise, we add both
-      else {
-        nodes[node_idx]->setNeighbours(
-            nodes[top_idx + 1]);  // top-right neighbour
-        nodes[node_idx]->setNeighbours(
-            nodes[bottom_idx + 1]);  // bottom-right neighbour
-      }
-    }
-  }
-
-  // if the cell is not at the left-edge of 2D grid,
-  // we find all the left, top-left and bottom-left neighbours
-  if (cell_mod_width != 0) {
-    nodes[node_idx]->setNeighbours(nodes[node_idx - 1]);  // left neighbour
-
-    if (use_eight_connectivity) {
-      // now find if node is at top edge or bottom edge or otherwise
-      if (cell_minus_width < 0) {  // if at top-edge
-        nodes[node_idx]->setNeighbours(
-            nodes[bottom_idx - 1]);  // bottom-left neighbour
-      }
-      // if at bottom-edge
-      else if (cell_plus_width >= size) {
-        nodes[node_idx]->setNeighbours(
-            nodes[top_idx - 1]);  // top-left neighbour
-      }
-      // otherwise, we add both
-      else {
-        nodes[node_idx]->setNeighbours(
-            nodes[top_idx - 1]);  // top-right neighbour
-        nodes[node_idx]->setNeighbours(
-            nodes[bottom_idx - 1]);  // bottom-right neighbour
-      }
-    }
+  static const int offsets[8][2] = {{-1, 0}, {1, 0},  {0, 1},  {-1, 1},
+                                    {1, 1},  {0, -1}, {-1, -1}, {1, -1}};
+  int n = 0;
+  for (int i = 0; i < 8; i++) {
+    const bool diagonal = offsets[i][0] != 0 && offsets[i][1] != 0;
+    if (diagonal && !use_eight_connectivity) continue;
+
+    const int x = pos.x + offsets[i][0];
+    const int y = pos.y + offsets[i][1];
+    if (x < 0 || x >= rows || y < 0 || y >= cols) continue;
+    neighbours[n++] = sf::Vector2i(x, y);
   }
+  return n;
 }
 
 }  // namespace utils
 }  // namespace graph_based
-}  // namespace path_finding_visualizer
\ No newline at end of file
+}  // namespace path_finding_visualizer
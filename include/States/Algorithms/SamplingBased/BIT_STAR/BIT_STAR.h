@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <queue>
+
+#include "States/Algorithms/SamplingBased/INFORMED_RRT_STAR/INFORMED_RRT_STAR.h"
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+/**
+ * @brief Batch Informed Trees (BIT*)
+ * Samples of the informed set are added in batches, the tree grows by
+ * processing the edges to them in order of the solution cost they could
+ * give. Edges are collision checked lazily, only once they are the best
+ * candidate left and can still improve the current solution.
+ */
+class BIT_STAR : public INFORMED_RRT_STAR {
+ public:
+  // Constructor
+  BIT_STAR(std::shared_ptr<gui::LoggerPanel> logger_panel,
+           std::shared_ptr<ThreadPool> thread_pool, const std::string &name);
+
+  // Destructor
+  virtual ~BIT_STAR();
+
+  virtual void renderParametersGui() override;
+  virtual void renderStats() override;
+
+  // override initialization functions
+  virtual void initPlanner() override;
+  virtual void initParameters() override;
+
+  // override algorithm function, every iteration processes one edge
+  virtual void updatePlanner(bool &solved, Vertex &start,
+                             Vertex &goal) override;
+  // the goal is a sample of every batch already
+  virtual bool supportsGoalBias() const override { return false; }
+
+  /**
+   * @brief Prune the samples & vertices that cannot improve the solution,
+   * then add a batch of samples and queue all tree vertices for expansion
+   */
+  void newBatch();
+
+  /**
+   * @brief Queue the edges from a tree vertex to the samples around it,
+   * and the rewires to the vertices around it if it is new in the batch
+   */
+  void expandVertex(std::uint32_t id);
+
+  /**
+   * @brief Connection radius for the current number of samples & vertices
+   */
+  double connectionRadius() const;
+
+ protected:
+  // edge from a tree vertex to a sample or to another tree vertex, ordered
+  // by the estimated cost of a solution through it
+  struct QueueEdge {
+    double key;
+    std::uint32_t from;
+    std::uint32_t to;
+    bool to_vertex;
+  };
+  struct QueueEdgeGreater {
+    bool operator()(const QueueEdge &a, const QueueEdge &b) const {
+      return a.key > b.key;
+    }
+  };
+  using QueueVertex = std::pair<double, std::uint32_t>;
+
+  // admissible estimates of the cost from the start & to the goal
+  double gHat(const Vertex &v) const { return distance(*start_vertex_, v); }
+  double hHat(const Vertex &v) const { return distance(v, *goal_vertex_); }
+
+  void addSample(const Vertex &v);
+  void processEdge(const QueueEdge &e, Vertex &goal);
+  void pruneBatch();
+
+  /**
+   * @brief Number of samples drawn per batch
+   */
+  int batch_size_;
+
+  // samples not in the tree yet, sample_vertex_ holds the tree vertex of a
+  // sample once it is connected
+  std::vector<Vertex> samples_;
+  std::vector<std::uint32_t> sample_vertex_;
+  std::unique_ptr<NearestNeighbors> sample_nn_;
+  std::size_t no_of_unconnected_;
+  // samples from this index on were added in the current batch
+  std::uint32_t first_new_sample_;
+  std::uint32_t goal_sample_;
+  std::uint32_t goal_id_;
+
+  std::priority_queue<QueueVertex, std::vector<QueueVertex>,
+                      std::greater<QueueVertex>>
+      vertex_queue_;
+  std::priority_queue<QueueEdge, std::vector<QueueEdge>, QueueEdgeGreater>
+      edge_queue_;
+
+  // marks the vertices that were in the tree before the current batch
+  std::vector<std::uint8_t> is_old_;
+  double radius_;
+
+  // UI reads this
+  std::atomic<std::size_t> no_of_batches_{0u};
+};
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
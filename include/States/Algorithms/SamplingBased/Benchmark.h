@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Gui.h"
+#include "ThreadPool.h"
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+class SamplingBased;
+
+/**
+ * @brief Planners the benchmark can run
+ */
+static const std::vector<std::string> BENCHMARK_PLANNERS{
+    "RRT", "RRT*", "RRT-Connect", "Informed RRT*", "BIT*"};
+enum BENCHMARK_PLANNERS_IDS {
+  BENCHMARK_RRT,
+  BENCHMARK_RRT_STAR,
+  BENCHMARK_RRT_CONNECT,
+  BENCHMARK_INFORMED_RRT_STAR,
+  BENCHMARK_BIT_STAR
+};
+
+// progress samples recorded per run, evenly spread over the time limit
+static constexpr std::size_t BENCHMARK_SAMPLES = 100u;
+
+/**
+ * @brief State of a benchmark run at one of the sample times
+ */
+struct BenchmarkSample {
+  double time;
+  // infinity until a solution is found
+  double best_cost;
+  std::size_t tree_size;
+  std::size_t collision_checks;
+  std::size_t iterations;
+};
+
+/**
+ * @brief Outcome of one planner run with one seed
+ */
+struct BenchmarkRun {
+  int planner;
+  std::uint32_t seed;
+  // infinity if no solution was found
+  double time_to_first_solution;
+  double time;
+  std::vector<BenchmarkSample> samples;
+};
+
+/**
+ * @brief Runs sampling-based planners repeatedly on the map of a planner
+ * Every selected planner runs once per seed on its own copy of the map.
+ * Runs go one after the other on a single worker of the thread pool, so
+ * they neither share cores nor depend on the scheduling. Planners run
+ * without recording a trace and their progress is sampled at fixed times.
+ */
+class Benchmark {
+ public:
+  Benchmark(std::shared_ptr<gui::LoggerPanel> logger_panel,
+            std::shared_ptr<ThreadPool> thread_pool);
+
+  // Destructor, stops the runs
+  ~Benchmark();
+
+  Benchmark(const Benchmark &) = delete;
+  Benchmark &operator=(const Benchmark &) = delete;
+
+  /**
+   * @brief Start the runs on the obstacles, start & goal of the host
+   */
+  void start(const SamplingBased &host);
+  void stop();
+  bool isRunning() const;
+
+  // report finished runs (UI thread)
+  void update();
+
+  void renderGui(const SamplingBased &host);
+  void renderStats();
+
+  /**
+   * @brief One row per progress sample of every run
+   */
+  bool exportCsv(const std::string &filename) const;
+
+  /**
+   * @brief Log in the format read by ompl_benchmark_statistics.py
+   */
+  bool exportLog(const std::string &filename) const;
+
+ private:
+  // run every planner & seed (thread pool)
+  void runAll(std::vector<std::unique_ptr<SamplingBased>> planners,
+              std::vector<int> planner_ids, int no_of_runs, int first_seed);
+  BenchmarkRun runOnce(SamplingBased &planner, int planner_id,
+                       std::uint32_t seed) const;
+
+  // median & quartiles of the best cost over time of every planner
+  void renderCostPlot(const std::vector<BenchmarkRun> &runs) const;
+
+  std::shared_ptr<gui::LoggerPanel> logger_panel_;
+  std::shared_ptr<ThreadPool> thread_pool_;
+
+  // parameters
+  std::vector<std::uint8_t> is_selected_;
+  int no_of_runs_;
+  int first_seed_;
+  double time_limit_;
+  char filename_[256];
+
+  // experiment of the last start, fixed while it runs
+  std::string start_time_;
+  double run_time_limit_;
+  std::vector<std::string> common_properties_;
+  double total_time_;
+
+  // finished runs, appended by the benchmark job
+  mutable std::mutex runs_mutex_;
+  std::vector<BenchmarkRun> runs_;
+  std::size_t no_of_planned_runs_;
+
+  std::atomic<bool> is_stopped_{false};
+  std::atomic<bool> is_running_{false};
+  std::future<void> job_;
+};
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
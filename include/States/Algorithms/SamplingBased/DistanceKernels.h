@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+/**
+ * @brief Batched squared-distance kernels over structure-of-arrays points
+ * The vectorized versions are picked at compile time (AVX2 if enabled, else
+ * SSE2 on x86-64) and return exactly what the scalar ones return, ties
+ * included, so planner runs stay reproducible across builds.
+ */
+
+/**
+ * @brief Name of the instruction set the kernels were built for
+ */
+inline const char *distanceKernelName() {
+#if defined(__AVX2__)
+  return "AVX2";
+#elif defined(__SSE2__)
+  return "SSE2";
+#else
+  return "scalar";
+#endif
+}
+
+/**
+ * @brief Find the first point strictly closer than min_dist to (x, y)
+ * @param min_dist Squared distance to beat, updated to the one found
+ * @return Index of the closest point, n if none is closer than min_dist
+ */
+inline std::size_t argminSquaredDistanceScalar(const double *xs,
+                                               const double *ys, std::size_t n,
+                                               double x, double y,
+                                               double &min_dist) {
+  std::size_t min_i = n;
+  for (std::size_t i = 0u; i < n; ++i) {
+    const double dx = xs[i] - x, dy = ys[i] - y;
+    const double d = dx * dx + dy * dy;
+    if (d < min_dist) {
+      min_dist = d;
+      min_i = i;
+    }
+  }
+  return min_i;
+}
+
+/**
+ * @brief Append ids[i] of every point strictly closer than sqrt(r2) to
+ * (x, y), in index order
+ */
+inline void withinRadiusScalar(const double *xs, const double *ys,
+                               const std::uint32_t *ids, std::size_t n,
+                               double x, double y, double r2,
+                               std::vector<std::uint32_t> &out) {
+  for (std::size_t i = 0u; i < n; ++i) {
+    const double dx = xs[i] - x, dy = ys[i] - y;
+    if (dx * dx + dy * dy < r2) out.push_back(ids[i]);
+  }
+}
+
+#if defined(__AVX2__)
+
+inline std::size_t argminSquaredDistance(const double *xs, const double *ys,
+                                         std::size_t n, double x, double y,
+                                         double &min_dist) {
+  const __m256d qx = _mm256_set1_pd(x), qy = _mm256_set1_pd(y);
+  __m256d best = _mm256_set1_pd(min_dist);
+  // lane indices are kept as doubles, exact far beyond any tree size
+  __m256d best_i = _mm256_set1_pd(-1.0);
+  __m256d idx = _mm256_setr_pd(0.0, 1.0, 2.0, 3.0);
+  const __m256d step = _mm256_set1_pd(4.0);
+
+  std::size_t i = 0u;
+  for (; i + 4u <= n; i += 4u) {
+    const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(xs + i), qx);
+    const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ys + i), qy);
+    const __m256d d =
+        _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+    const __m256d closer = _mm256_cmp_pd(d, best, _CMP_LT_OQ);
+    best = _mm256_blendv_pd(best, d, closer);
+    best_i = _mm256_blendv_pd(best_i, idx, closer);
+    idx = _mm256_add_pd(idx, step);
+  }
+
+  // reduce the lanes, ties go to the lower index like in the scalar loop
+  alignas(32) double lane_d[4], lane_i[4];
+  _mm256_store_pd(lane_d, best);
+  _mm256_store_pd(lane_i, best_i);
+  std::size_t min_i = n;
+  for (int k = 0; k < 4; ++k) {
+    if (lane_i[k] < 0.0) continue;
+    const std::size_t li = static_cast<std::size_t>(lane_i[k]);
+    if (lane_d[k] < min_dist || (lane_d[k] == min_dist && li < min_i)) {
+      min_dist = lane_d[k];
+      min_i = li;
+    }
+  }
+
+  const std::size_t tail_i =
+      argminSquaredDistanceScalar(xs + i, ys + i, n - i, x, y, min_dist);
+  return tail_i < n - i ? i + tail_i : min_i;
+}
+
+inline void withinRadius(const double *xs, const double *ys,
+                         const std::uint32_t *ids, std::size_t n, double x,
+                         double y, double r2,
+                         std::vector<std::uint32_t> &out) {
+  const __m256d qx = _mm256_set1_pd(x), qy = _mm256_set1_pd(y);
+  const __m256d r2v = _mm256_set1_pd(r2);
+
+  std::size_t i = 0u;
+  for (; i + 4u <= n; i += 4u) {
+    const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(xs + i), qx);
+    const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ys + i), qy);
+    const __m256d d =
+        _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+    int mask = _mm256_movemask_pd(_mm256_cmp_pd(d, r2v, _CMP_LT_OQ));
+    while (mask != 0) {
+      out.push_back(ids[i + __builtin_ctz(mask)]);
+      mask &= mask - 1;
+    }
+  }
+  withinRadiusScalar(xs + i, ys + i, ids + i, n - i, x, y, r2, out);
+}
+
+#elif defined(__SSE2__)
+
+inline std::size_t argminSquaredDistance(const double *xs, const double *ys,
+                                         std::size_t n, double x, double y,
+                                         double &min_dist) {
+  const __m128d qx = _mm_set1_pd(x), qy = _mm_set1_pd(y);
+  __m128d best = _mm_set1_pd(min_dist);
+  // lane indices are kept as doubles, exact far beyond any tree size
+  __m128d best_i = _mm_set1_pd(-1.0);
+  __m128d idx = _mm_setr_pd(0.0, 1.0);
+  const __m128d step = _mm_set1_pd(2.0);
+
+  std::size_t i = 0u;
+  for (; i + 2u <= n; i += 2u) {
+    const __m128d dx = _mm_sub_pd(_mm_loadu_pd(xs + i), qx);
+    const __m128d dy = _mm_sub_pd(_mm_loadu_pd(ys + i), qy);
+    const __m128d d = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+    // SSE2 has no blend, select through the comparison mask
+    const __m128d closer = _mm_cmplt_pd(d, best);
+    best = _mm_or_pd(_mm_and_pd(closer, d), _mm_andnot_pd(closer, best));
+    best_i = _mm_or_pd(_mm_and_pd(closer, idx), _mm_andnot_pd(closer, best_i));
+    idx = _mm_add_pd(idx, step);
+  }
+
+  // reduce the lanes, ties go to the lower index like in the scalar loop
+  alignas(16) double lane_d[2], lane_i[2];
+  _mm_store_pd(lane_d, best);
+  _mm_store_pd(lane_i, best_i);
+  std::size_t min_i = n;
+  for (int k = 0; k < 2; ++k) {
+    if (lane_i[k] < 0.0) continue;
+    const std::size_t li = static_cast<std::size_t>(lane_i[k]);
+    if (lane_d[k] < min_dist || (lane_d[k] == min_dist && li < min_i)) {
+      min_dist = lane_d[k];
+      min_i = li;
+    }
+  }
+
+  const std::size_t tail_i =
+      argminSquaredDistanceScalar(xs + i, ys + i, n - i, x, y, min_dist);
+  return tail_i < n - i ? i + tail_i : min_i;
+}
+
+inline void withinRadius(const double *xs, const double *ys,
+                         const std::uint32_t *ids, std::size_t n, double x,
+                         double y, double r2,
+                         std::vector<std::uint32_t> &out) {
+  const __m128d qx = _mm_set1_pd(x), qy = _mm_set1_pd(y);
+  const __m128d r2v = _mm_set1_pd(r2);
+
+  std::size_t i = 0u;
+  for (; i + 2u <= n; i += 2u) {
+    const __m128d dx = _mm_sub_pd(_mm_loadu_pd(xs + i), qx);
+    const __m128d dy = _mm_sub_pd(_mm_loadu_pd(ys + i), qy);
+    const __m128d d = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+    const int mask = _mm_movemask_pd(_mm_cmplt_pd(d, r2v));
+    if (mask & 1) out.push_back(ids[i]);
+    if (mask & 2) out.push_back(ids[i + 1u]);
+  }
+  withinRadiusScalar(xs + i, ys + i, ids + i, n - i, x, y, r2, out);
+}
+
+#else
+
+inline std::size_t argminSquaredDistance(const double *xs, const double *ys,
+                                         std::size_t n, double x, double y,
+                                         double &min_dist) {
+  return argminSquaredDistanceScalar(xs, ys, n, x, y, min_dist);
+}
+
+inline void withinRadius(const double *xs, const double *ys,
+                         const std::uint32_t *ids, std::size_t n, double x,
+                         double y, double r2,
+                         std::vector<std::uint32_t> &out) {
+  withinRadiusScalar(xs, ys, ids, n, x, y, r2, out);
+}
+
+#endif
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <limits>
+
+#include "States/Algorithms/SamplingBased/RRT_STAR/RRT_STAR.h"
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+/**
+ * @brief RRT* focused on the informed set once a solution is found
+ * Samples are drawn from the ellipse of all points that could improve the
+ * current best cost, and vertices that cannot improve it are pruned.
+ */
+class INFORMED_RRT_STAR : public RRT_STAR {
+ public:
+  // Constructor
+  INFORMED_RRT_STAR(std::shared_ptr<gui::LoggerPanel> logger_panel,
+                    std::shared_ptr<ThreadPool> thread_pool,
+                    const std::string &name);
+
+  // Destructor
+  virtual ~INFORMED_RRT_STAR();
+
+  virtual void renderParametersGui() override;
+  virtual void renderStats() override;
+
+  // override initialization functions
+  virtual void initPlanner() override;
+  virtual void initParameters() override;
+
+  // override algorithm function
+  virtual void updatePlanner(bool &solved, Vertex &start,
+                             Vertex &goal) override;
+  // pruning rebuilds the spatial index under the other workers
+  virtual bool supportsParallelGrowth() const override { return false; }
+  // the informed set & the pruning of the tree depend on the old goal
+  virtual bool supportsGoalReuse() const override { return false; }
+
+  /**
+   * @brief Uniformly sample the informed set, the whole map until solved
+   * @param v Sampled vertex
+   */
+  virtual void sample(Vertex &v) override;
+
+  /**
+   * @brief Remove the vertices that cannot improve the best cost
+   * Cost-to-come plus the straight-line cost-to-go never decreases along a
+   * tree edge, so the pruned vertices always form whole subtrees.
+   */
+  void prune(const Vertex &goal);
+
+ protected:
+  /**
+   * @brief Cost of the current solution, infinity until solved
+   */
+  double best_cost_;
+
+  /**
+   * @brief Best cost at the last pruning
+   */
+  double pruned_cost_;
+
+  /**
+   * @brief Prune once the best cost improved by this fraction
+   */
+  double prune_threshold_;
+
+  /**
+   * @brief Vertices removed from the tree (UI reads it)
+   */
+  std::atomic<std::size_t> no_of_pruned_{0u};
+};
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+/**
+ * @brief Available nearest neighbour backends
+ */
+enum NN_BACKEND { NN_LINEAR, NN_KDTREE, NN_GRID };
+static const std::vector<std::string> NN_BACKEND_NAMES{"linear", "k-d tree",
+                                                       "grid hash"};
+
+/**
+ * @brief Spatial index over the vertices of a tree in the unit square
+ * Vertices are referred to by their ids in the tree. Const queries may run
+ * concurrently with each other, but not with add() or clear().
+ */
+class NearestNeighbors {
+ public:
+  virtual ~NearestNeighbors() {}
+
+  /**
+   * @brief Remove all the vertices
+   */
+  virtual void clear() = 0;
+
+  /**
+   * @brief Insert a vertex
+   */
+  virtual void add(std::uint32_t id, double x, double y) = 0;
+
+  /**
+   * @brief Preallocate storage for n vertices
+   */
+  virtual void reserve(std::size_t n) = 0;
+
+  /**
+   * @brief Find the vertex closest to a point
+   * @return Id of the nearest vertex, the index must not be empty
+   */
+  virtual std::uint32_t nearest(double x, double y) const = 0;
+
+  /**
+   * @brief Find all the vertices strictly closer than r to a point
+   * @param ids Ids of the vertices found are appended to this vector
+   */
+  virtual void radius(double x, double y, double r,
+                      std::vector<std::uint32_t> &ids) const = 0;
+
+  virtual std::size_t size() const = 0;
+};
+
+/**
+ * @brief Brute force search over all the vertices, O(n) per query
+ * Coordinates are stored as separate arrays for the vectorized kernels.
+ */
+class LinearNN : public NearestNeighbors {
+ public:
+  void clear() override;
+  void add(std::uint32_t id, double x, double y) override;
+  void reserve(std::size_t n) override;
+  std::uint32_t nearest(double x, double y) const override;
+  void radius(double x, double y, double r,
+              std::vector<std::uint32_t> &ids) const override;
+  std::size_t size() const override { return ids_.size(); }
+
+ private:
+  std::vector<double> xs_, ys_;
+  std::vector<std::uint32_t> ids_;
+};
+
+/**
+ * @brief Incremental 2D k-d tree
+ * Vertices are inserted as leaves without rebalancing. Samples of the
+ * planners are spread uniformly, so the expected depth and query time stay
+ * O(log n).
+ */
+class KdTreeNN : public NearestNeighbors {
+ public:
+  void clear() override;
+  void add(std::uint32_t id, double x, double y) override;
+  void reserve(std::size_t n) override;
+  std::uint32_t nearest(double x, double y) const override;
+  void radius(double x, double y, double r,
+              std::vector<std::uint32_t> &ids) const override;
+  std::size_t size() const override { return nodes_.size(); }
+
+ private:
+  static constexpr std::int32_t NO_CHILD = -1;
+  struct Node {
+    double p[2];
+    std::uint32_t id;
+    std::int32_t child[2];  // below & above the split value
+  };
+  struct StackEntry {
+    std::int32_t node;
+    int depth;
+    double bound;  // lower bound of the squared distance to the subtree
+  };
+  // nodes split on x at even depths and on y at odd depths
+  std::vector<Node> nodes_;
+};
+
+/**
+ * @brief Uniform grid over the unit square
+ * The resolution doubles whenever the average bucket holds more than a few
+ * vertices, so both queries only look at O(1) buckets on average.
+ */
+class GridNN : public NearestNeighbors {
+ public:
+  GridNN();
+  void clear() override;
+  void add(std::uint32_t id, double x, double y) override;
+  void reserve(std::size_t n) override;
+  std::uint32_t nearest(double x, double y) const override;
+  void radius(double x, double y, double r,
+              std::vector<std::uint32_t> &ids) const override;
+  std::size_t size() const override { return points_.size(); }
+
+ private:
+  struct Point {
+    double x, y;
+    std::uint32_t id;
+  };
+  // vertices of a bucket as separate arrays for the vectorized kernels
+  struct Bucket {
+    std::vector<double> xs, ys;
+    std::vector<std::uint32_t> ids;
+    void push(const Point &p) {
+      xs.push_back(p.x);
+      ys.push_back(p.y);
+      ids.push_back(p.id);
+    }
+  };
+  int cellCoord(double v) const;
+  void rebuild(int resolution);
+
+  int resolution_;
+  std::vector<Point> points_;
+  // row-major
+  std::vector<Bucket> buckets_;
+};
+
+/**
+ * @brief Create a nearest neighbour backend
+ * @param backend One of NN_BACKEND
+ */
+std::unique_ptr<NearestNeighbors> makeNearestNeighbors(int backend);
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+/**
+ * @brief Axis-aligned rectangles & convex polygons of the planning map
+ * Obstacles live in flat arrays, their corners in one shared vertex array,
+ * and are indexed by a bounding volume hierarchy over their boxes. Segment
+ * & point queries are exact and only visit the obstacles whose box they
+ * touch. Coordinates are in map pixels, x to the right and y downwards.
+ * Edits leave the hierarchy stale until build() is called, queries may
+ * then run concurrently.
+ */
+class ObstacleSet {
+ public:
+  static constexpr std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+  /**
+   * @brief Bounding box & corners of an obstacle
+   */
+  struct Obstacle {
+    float min_x, min_y, max_x, max_y;
+    // corners in counter-clockwise order, a span of the vertex array
+    std::uint32_t first_vertex;
+    std::uint32_t no_of_vertices;
+    // the box is the obstacle, no polygon test needed
+    bool is_box;
+  };
+
+  /**
+   * @brief Add the rectangle [x, x + w] x [y, y + h]
+   */
+  void addRect(float x, float y, float w, float h);
+
+  /**
+   * @brief Add the convex hull of a set of points
+   * @return false if the hull has no area, nothing is added then
+   */
+  bool addPolygon(const std::vector<float> &xs, const std::vector<float> &ys);
+
+  /**
+   * @brief Remove an obstacle, the last one takes its index
+   */
+  void remove(std::size_t i);
+  void clear();
+
+  /**
+   * @brief Rebuild the hierarchy after edits
+   */
+  void build();
+
+  /**
+   * @brief Index of an obstacle containing the point, NONE if it is free
+   * Of several overlapping obstacles the one with the highest index wins.
+   */
+  std::size_t pick(double x, double y) const;
+
+  /**
+   * @brief Check whether the segment from (x0, y0) to (x1, y1) touches an
+   * obstacle, a zero-length segment checks a single point
+   * @return true if there is a collision otherwise false
+   */
+  bool segmentCollides(double x0, double y0, double x1, double y1) const;
+
+  std::size_t size() const { return obstacles_.size(); }
+  bool empty() const { return obstacles_.empty(); }
+  const Obstacle &operator[](std::size_t i) const { return obstacles_[i]; }
+  float vertexX(std::uint32_t v) const { return xs_[v]; }
+  float vertexY(std::uint32_t v) const { return ys_[v]; }
+  std::size_t bytes() const;
+
+ private:
+  /**
+   * @brief Node of the hierarchy
+   * Leaves hold count > 0 obstacles from first in order_, inner nodes have
+   * count 0 and their children at first & first + 1.
+   */
+  struct Node {
+    float min_x, min_y, max_x, max_y;
+    std::uint32_t first;
+    std::uint32_t count;
+  };
+
+  void appendObstacle(std::uint32_t first_vertex, bool is_box);
+  // build the subtree over order_[begin, end) into nodes_[node]
+  void buildNode(std::uint32_t node, std::uint32_t begin, std::uint32_t end);
+  bool polygonContains(const Obstacle &o, double x, double y) const;
+  bool polygonCrosses(const Obstacle &o, double x0, double y0, double x1,
+                      double y1) const;
+
+  std::vector<Obstacle> obstacles_;
+  std::vector<float> xs_, ys_;
+
+  std::vector<Node> nodes_;
+  // obstacle indices, grouped by leaf
+  std::vector<std::uint32_t> order_;
+};
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <limits>
+
+#include "States/Algorithms/SamplingBased/RRT/RRT.h"
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+/**
+ * @brief Multi-query PRM* with a persistent roadmap
+ * The roadmap is grown in batches of samples, the radius queries & edge
+ * collision checks of a batch run in parallel on the thread pool. It is
+ * kept across queries & resets while the obstacles and roadmap parameters
+ * stay the same, a query only connects the start & goal to it and runs A*.
+ */
+class PRM_STAR : public RRT {
+ public:
+  // Constructor
+  PRM_STAR(std::shared_ptr<gui::LoggerPanel> logger_panel,
+           std::shared_ptr<ThreadPool> thread_pool, const std::string &name);
+
+  // Destructor
+  virtual ~PRM_STAR();
+
+  virtual void renderParametersGui() override;
+  virtual void renderStats() override;
+
+  // override initialization functions
+  virtual void initialize() override;
+  virtual void initPlanner() override;
+  virtual void initParameters() override;
+
+  // override algorithm function
+  virtual void updatePlanner(bool &solved, Vertex &start,
+                             Vertex &goal) override;
+
+  // one worker drives the batches, growRoadmap() connects them in parallel
+  virtual bool supportsParallelGrowth() const override { return false; }
+  virtual bool supportsRequery() const override { return true; }
+  // goal samples would only pile up in the roadmap
+  virtual bool supportsGoalBias() const override { return false; }
+  virtual void requery() override;
+
+  /**
+   * @brief Sample a batch of vertices and connect them to the roadmap
+   * @param no_of_samples Number of samples drawn, invalid ones are dropped
+   */
+  void growRoadmap(unsigned int no_of_samples);
+
+  /**
+   * @brief Connect the start & goal to the roadmap and search it with A*
+   * The previous query is removed from the tree first.
+   * @return true if a path was found
+   */
+  bool query(const Vertex &start, Vertex &goal);
+
+  /**
+   * @brief Connection radius of PRM* for the current roadmap size
+   */
+  double connectionRadius() const;
+
+ protected:
+  // parameters the roadmap was built with, it is reused while they match
+  struct RoadmapKey {
+    unsigned int obstacles_revision;
+    int map_width, map_height;
+    int no_of_samples;
+    double rewire_factor;
+    int nn_backend;
+    bool operator==(const RoadmapKey &other) const {
+      return obstacles_revision == other.obstacles_revision &&
+             map_width == other.map_width && map_height == other.map_height &&
+             no_of_samples == other.no_of_samples &&
+             rewire_factor == other.rewire_factor &&
+             nn_backend == other.nn_backend;
+    }
+  };
+  RoadmapKey roadmapKey() const;
+
+  /**
+   * @brief Rewiring factor scaling the connection radius
+   */
+  double rewire_factor_;
+
+  /**
+   * @brief Number of samples drawn per batch
+   */
+  int batch_size_;
+
+  // roadmap, vertices [0, roadmap_size_) of vertices_ & their neighbours
+  std::uint32_t roadmap_size_;
+  std::vector<std::vector<std::uint32_t>> adjacency_;
+  std::atomic<std::size_t> no_of_edges_{0u};
+  std::unique_ptr<NearestNeighbors> roadmap_nn_;
+  RoadmapKey roadmap_key_;
+  bool is_roadmap_valid_;
+
+  // new edges of the current batch, one list per new vertex
+  std::vector<std::vector<std::uint32_t>> batch_edges_;
+
+  // A* state, indexed by roadmap vertex
+  std::vector<double> g_costs_;
+  std::vector<std::uint32_t> came_from_;
+  // cost of the edge to the goal, infinity if not connected
+  std::vector<double> goal_costs_;
+
+  // vertices of the last query & its path, cleared by the next query
+  std::vector<std::uint32_t> query_vertices_;
+
+  // outcome of the last query, read by the UI once solved
+  double path_cost_{std::numeric_limits<double>::infinity()};
+  double query_ms_{0.0};
+};
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
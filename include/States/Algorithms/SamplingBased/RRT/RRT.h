@@ -11,7 +11,8 @@ namespace sampling_based {
 class RRT : public SamplingBased {
  public:
   // Constructor
-  RRT(std::shared_ptr<gui::LoggerPanel> logger_panel, const std::string &name);
+  RRT(std::shared_ptr<gui::LoggerPanel> logger_panel,
+      std::shared_ptr<ThreadPool> thread_pool, const std::string &name);
 
   // Destructor
   virtual ~RRT();
@@ -28,40 +29,55 @@ class RRT : public SamplingBased {
   // override main update function
   virtual void updatePlanner(bool &solved, Vertex &start,
                              Vertex &goal) override;
+  virtual bool supportsParallelGrowth() const override { return true; }
+  virtual bool supportsGoalBias() const override { return true; }
+  virtual bool supportsGoalReuse() const override { return true; }
 
   /**
-   * @brief Randomly sample a vertex
+   * @brief Link the goal to the vertex within one extension that gives the
+   * cheapest collision-free path, found through the spatial index
+   * @param goal Goal vertex, its parent is NO_VERTEX if none is reachable
+   */
+  virtual void reconnectGoal(Vertex &goal) override;
+
+  /**
+   * @brief Grow the reserved tree to the new iteration limit
+   */
+  virtual void resumePlanner() override;
+
+  /**
+   * @brief Sample a vertex from the stream of the calling worker, or the
+   * goal with probability goal_bias_
    * @param v Sampled vertex
    */
-  void sample(const std::shared_ptr<Vertex> &v);
+  virtual void sample(Vertex &v);
 
   /**
    * @brief Find the nearest neighbour in a tree
-   * @param v Nearest vertex
+   * @return Id of the nearest tree vertex
    */
-  void nearest(const std::shared_ptr<const Vertex> &x_rand,
-               std::shared_ptr<Vertex> &x_near);
+  std::uint32_t nearest(const Vertex &x_rand);
 
   /**
-   * @brief The cost to come of a vertex (g-value)
+   * @brief The cost to come of a tree vertex (g-value)
+   * Costs are cached in the tree and kept up to date on rewiring, planners
+   * that rewire must synchronize the reads
    */
-  double cost(std::shared_ptr<Vertex> v);
+  double cost(std::uint32_t id) const;
 
   /**
    * @brief The euclidean distance between two vertices
    */
-  double distance(const std::shared_ptr<const Vertex> &v1,
-                  const std::shared_ptr<const Vertex> &v2);
+  double distance(const Vertex &v1, const Vertex &v2) const;
 
   /**
    * @brief Check whether collision or not between two vertices
-   * This function assumes from_v vertex is collision-free
+   * The edge is tested exactly against the obstacles near it
    * @param from_v Starting vertex
    * @param to_v Ending vertex
    * @return true if there is a collision otherwise false
    */
-  bool isCollision(const std::shared_ptr<const Vertex> &from_v,
-                   const std::shared_ptr<const Vertex> &to_v);
+  bool isCollision(const Vertex &from_v, const Vertex &to_v) const;
 
   /**
    * @brief Find the new interpolated vertex from from_v vertex to to_v
@@ -71,21 +87,15 @@ class RRT : public SamplingBased {
    * @param t Interpolation distance
    * @param v New vertex
    */
-  void interpolate(const std::shared_ptr<const Vertex> &from_v,
-                   const std::shared_ptr<const Vertex> &to_v, const double t,
-                   const std::shared_ptr<Vertex> &v);
+  void interpolate(const Vertex &from_v, const Vertex &to_v, const double t,
+                   Vertex &v) const;
 
   /**
    * @brief Check whether a vertex lies within goal radius or not
    */
-  bool inGoalRegion(const std::shared_ptr<const Vertex> &v);
+  bool inGoalRegion(const Vertex &v) const;
 
  protected:
-  /**
-   * @brief Interpolation distance during collsion checking
-   */
-  double interpolation_dist_;
-
   /**
    * @brief Maximum distance allowed between two vertices
    */
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "States/Algorithms/SamplingBased/RRT/RRT.h"
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+/**
+ * @brief Bidirectional RRT with greedy connect steps
+ * Trees grow from the start & the goal in turns, both stored in vertices_
+ * with their own spatial index. Once they meet, the goal tree is rerooted
+ * below the start tree so that the solution is a single path from the start.
+ */
+class RRT_CONNECT : public RRT {
+ public:
+  // Constructor
+  RRT_CONNECT(std::shared_ptr<gui::LoggerPanel> logger_panel,
+              std::shared_ptr<ThreadPool> thread_pool,
+              const std::string &name);
+
+  // Destructor
+  virtual ~RRT_CONNECT();
+
+  virtual void renderParametersGui() override;
+
+  // override initialization functions
+  virtual void initPlanner() override;
+  virtual void initParameters() override;
+
+  // override algorithm function
+  virtual void updatePlanner(bool &solved, Vertex &start,
+                             Vertex &goal) override;
+  virtual bool supportsParallelGrowth() const override { return false; }
+  // the second tree is rooted at the goal, a moved goal needs a new one
+  virtual bool supportsGoalReuse() const override { return false; }
+
+ protected:
+  enum TREE { START_TREE, GOAL_TREE };
+  enum EXTEND_STATUS { TRAPPED, ADVANCED, REACHED };
+
+  /**
+   * @brief Grow a tree by one step toward a target
+   * @param tree One of TREE
+   * @param target Vertex to extend toward
+   * @param new_id Id of the added vertex, unless trapped
+   * @return REACHED if the new vertex lies on the target
+   */
+  EXTEND_STATUS extend(int tree, const Vertex &target, std::uint32_t &new_id);
+
+  /**
+   * @brief Hang the goal tree below the start tree
+   * The path from goal_id to the goal root is reversed and attached below
+   * start_id. The path vertices get their new costs and the subtrees
+   * hanging off them follow their reparented path vertex.
+   */
+  void joinTrees(std::uint32_t start_id, std::uint32_t goal_id, Vertex &goal);
+
+  /**
+   * @brief Spatial index over the vertices of the goal tree
+   */
+  std::unique_ptr<NearestNeighbors> goal_nn_;
+
+  /**
+   * @brief Root of the goal tree in vertices_
+   */
+  std::uint32_t goal_root_;
+
+  /**
+   * @brief Tree extended toward the next sample
+   */
+  int current_tree_;
+};
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <random>
 
 #include "States/Algorithms/SamplingBased/RRT/RRT.h"
@@ -11,12 +12,13 @@ class RRT_STAR : public RRT {
  public:
   // Constructor
   RRT_STAR(std::shared_ptr<gui::LoggerPanel> logger_panel,
-           const std::string& name);
+           std::shared_ptr<ThreadPool> thread_pool, const std::string& name);
 
   // Destructor
   virtual ~RRT_STAR();
 
   virtual void renderParametersGui() override;
+  virtual void renderStats() override;
 
   // override initialization functions
   virtual void initialize() override;
@@ -26,22 +28,60 @@ class RRT_STAR : public RRT {
   // override algorithm function
   virtual void updatePlanner(bool& solved, Vertex& start,
                              Vertex& goal) override;
+  // repairs rebuild the spatial index under the other workers
+  virtual bool supportsParallelGrowth() const override {
+    return !lazy_collision_checking_;
+  }
+  virtual bool refinesSolution() const override { return true; }
+
+  /**
+   * @brief Collect the vertices within the goal radius of the moved goal &
+   * pick the cheapest as goal parent, RRT::reconnectGoal() if there are none
+   */
+  virtual void reconnectGoal(Vertex& goal) override;
+  virtual void resumePlanner() override;
 
   /**
    * @brief Find all the nearest neighbours inside the radius of particular
    * vertex provided
    * @param x_new Target vertex
-   * @param X_near Vector of nearest neighbours
+   * @param X_near Ids of the nearest neighbours, cleared first
    */
-  void near(const std::shared_ptr<const Vertex>& x_new,
-            std::vector<std::shared_ptr<Vertex>>& X_near);
+  void near(const Vertex& x_new, std::vector<std::uint32_t>& X_near);
 
   /**
    * @brief Calculate r_rrt_ based on current measure
    */
   void updateRewiringLowerBounds();
 
+  /**
+   * @brief Pick the cheapest vertex within the goal radius as goal parent
+   */
+  void updateGoal(Vertex& goal);
+
+  /**
+   * @brief Cost through the cheapest vertex within the goal radius, which
+   * updateGoal() only links every update_goal_every_ iterations
+   */
+  virtual double bestSolutionCost(const Vertex& goal) const override;
+
+  /**
+   * @brief Collision check the unchecked edges from a vertex up to the root
+   * The first invalid edge found is repaired.
+   * @return true if the whole path is collision free
+   */
+  bool validatePath(std::uint32_t id);
+
+  /**
+   * @brief Move a vertex with an invalid parent edge under the cheapest
+   * valid parent around it, or prune its subtree if there is none
+   */
+  void repairEdge(std::uint32_t id);
+
  protected:
+  // collision state of the edges to the near vertices
+  enum NEAR_FLAG : std::uint8_t { UNCHECKED, FREE, BLOCKED };
+
   /**
    * @brief Find best goal parent at every n iteration
    */
@@ -65,7 +105,28 @@ class RRT_STAR : public RRT {
   /**
    * @brief Vertices that lie within the goal radius
    */
-  std::vector<std::shared_ptr<Vertex>> x_soln_;
+  std::vector<std::uint32_t> x_soln_;
+
+  /**
+   * @brief Only check vertices while growing, edges once on the best path
+   */
+  bool lazy_collision_checking_;
+
+  // marks the vertices whose edge to their parent is known to be free
+  std::vector<std::uint8_t> is_edge_checked_;
+
+  // marks the vertices removed from the tree by id
+  std::vector<std::uint8_t> is_pruned_;
+
+  // UI reads this
+  std::atomic<std::size_t> no_of_repairs_{0u};
+
+  /**
+   * @brief Guards parents, costs & x_soln_ of the tree
+   * Workers read a snapshot of the costs under a shared lock, then apply
+   * the parent choice, the new vertex & the rewires under an exclusive one.
+   */
+  std::shared_mutex tree_mutex_;
 };
 
 }  // namespace sampling_based
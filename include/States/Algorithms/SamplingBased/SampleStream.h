@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+/**
+ * @brief Available sample streams
+ */
+enum SAMPLER { SAMPLER_UNIFORM, SAMPLER_HALTON, SAMPLER_SOBOL };
+static const std::vector<std::string> SAMPLER_NAMES{"uniform", "Halton",
+                                                    "Sobol"};
+
+/**
+ * @brief Deterministic stream of points in the unit square
+ * The same seed & worker always give the same points. Points are generated
+ * in batches so that the planners pay one virtual call per batch.
+ */
+class SampleStream {
+ public:
+  virtual ~SampleStream() {}
+
+  /**
+   * @brief Write the next n points of the stream
+   */
+  virtual void generate(double *xs, double *ys, std::size_t n) = 0;
+};
+
+/**
+ * @brief Pseudo-random points from a mt19937
+ */
+class UniformStream : public SampleStream {
+ public:
+  UniformStream(std::uint32_t seed, std::size_t worker);
+  void generate(double *xs, double *ys, std::size_t n) override;
+
+ private:
+  std::mt19937 rn_gen_;
+};
+
+/**
+ * @brief Halton sequence in bases 2 & 3 with a random shift modulo 1
+ */
+class HaltonStream : public SampleStream {
+ public:
+  HaltonStream(std::uint32_t seed, std::size_t worker);
+  void generate(double *xs, double *ys, std::size_t n) override;
+
+ private:
+  std::uint64_t index_;
+  double shift_x_, shift_y_;
+};
+
+/**
+ * @brief Two dimensional Sobol sequence with a random digital shift
+ */
+class SobolStream : public SampleStream {
+ public:
+  SobolStream(std::uint32_t seed, std::size_t worker);
+  void generate(double *xs, double *ys, std::size_t n) override;
+
+ private:
+  std::uint32_t index_;
+  // current point as 32 bit fractions, before the shift
+  std::uint32_t x_, y_;
+  std::uint32_t shift_x_, shift_y_;
+};
+
+/**
+ * @brief Create a sample stream
+ * Workers of a run share the seed, quasi-random streams give each worker
+ * its own block of the sequence.
+ * @param sampler One of SAMPLER
+ */
+std::unique_ptr<SampleStream> makeSampleStream(int sampler, std::uint32_t seed,
+                                               std::size_t worker);
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
@@ -3,16 +3,23 @@
 #include <imgui-SFML.h>
 #include <imgui.h>
 
+#include <atomic>
 #include <condition_variable>
 #include <future>
 #include <memory>
 #include <mutex>
 #include <random>
+#include <shared_mutex>
 #include <vector>
 
 #include "MessageQueue.h"
 #include "State.h"
+#include "States/Algorithms/SamplingBased/Benchmark.h"
+#include "States/Algorithms/SamplingBased/NearestNeighbors.h"
+#include "States/Algorithms/SamplingBased/ObstacleSet.h"
+#include "States/Algorithms/SamplingBased/SampleStream.h"
 #include "States/Algorithms/SamplingBased/Utils.h"
+#include "States/Algorithms/SamplingBased/VertexArena.h"
 
 namespace path_finding_visualizer {
 namespace sampling_based {
@@ -22,16 +29,35 @@ static const sf::Color START_COL = sf::Color(0, 255, 0, 255);
 static const sf::Color GOAL_COL = sf::Color(255, 0, 0, 255);
 static const sf::Color EDGE_COL = sf::Color(0, 0, 255, 255);
 static const sf::Color PATH_COL = sf::Color(255, 0, 255, 255);
+static const sf::Color ROADMAP_COL = sf::Color(160, 160, 255, 255);
+static const sf::Color SMOOTH_PATH_COL = sf::Color(255, 140, 0, 255);
 
+/**
+ * @brief Shapes the left mouse button adds to the map
+ */
+static const std::vector<std::string> OBSTACLE_TOOLS{"square", "rectangle",
+                                                     "polygon"};
+enum OBSTACLE_TOOLS_IDS { TOOL_SQUARE, TOOL_RECTANGLE, TOOL_POLYGON };
+
+// replayed edges are binned by their child vertex on a grid over the map
+static constexpr int REPLAY_BINS = 64;
+
+// sample points each worker pre-generates at once
+static constexpr std::size_t SAMPLE_BATCH = 256u;
+
+// a standalone state, e.g. a sample or the start & goal of a query
+// tree vertices live in a VertexArena and are referred to by their ids
 struct Vertex {
   double x, y;
-  std::shared_ptr<Vertex> parent{nullptr};
+  // id of the parent vertex in the tree
+  std::uint32_t parent{NO_VERTEX};
 };
 
 class SamplingBased : public State {
  public:
   // Constructor
   SamplingBased(std::shared_ptr<gui::LoggerPanel> logger_panel,
+                std::shared_ptr<ThreadPool> thread_pool,
                 const std::string &name);
 
   // Destructor
@@ -42,15 +68,65 @@ class SamplingBased : public State {
   void update(const float &dt, const ImVec2 &mousePos) override;
   void renderConfig() override;
   void renderScene(sf::RenderTexture &render_texture) override;
+  void resetReplay() override;
+  void applyTraceEvent(const TraceEvent &e) override;
+  void renderStats() override;
+  bool supportsReplayExport() const override { return true; }
+  // one row per replayed vertex: id, position, parent & solution flag
+  bool exportReplay(const std::string &filename) const override;
+  // benchmark runs are timed, planning must not share the cores with them
+  bool canRun() const override { return !benchmark_.isRunning(); }
 
   void updateUserInput();
   void renderMap(sf::RenderTexture &render_texture);
   void renderObstacles(sf::RenderTexture &render_texture);
+  void renderReplayTree(sf::RenderTexture &render_texture);
   void clearObstacles();
+  // rebuild the hierarchy & the triangles of obstacles_ after edits
+  void updateObstacles();
+  // add random rectangles & convex polygons, keeping the start & goal free
+  void generateObstacles(int no_of_obstacles);
   void initMapVariables();
   void initVariables();
   void updateKeyTime(const float &dt);
   const bool getKeyTime();
+  void updatePlanningRate(const float &dt);
+  // reset the tree, the workers & the planner for a new run
+  void initRun();
+  // continue the last run on its tree & trace with another max_iterations_
+  void resumeRun();
+  // link a moved goal into the tree of the solved query (UI thread)
+  void reuseTree();
+
+  // position of a tree vertex (solver threads)
+  Vertex treeVertex(std::uint32_t id) const;
+  // insert a tree vertex into nn_, publishing it to the other workers
+  void indexVertex(std::uint32_t id);
+  // take the next iteration number, false once iteration_limit_ is reached
+  bool claimIteration(unsigned int &iter_no);
+  // next point of the sample stream of the calling worker
+  void nextSample(double &x, double &y);
+  // post-process the tree path from the start to goal into smoothed_path_
+  void smoothSolution(const Vertex &goal);
+  // length of the tree path into the goal, infinity if there is none
+  double solutionCost(const Vertex &goal) const;
+  // cost of the best solution in the tree, including candidates the planner
+  // has not linked to the goal yet
+  virtual double bestSolutionCost(const Vertex &goal) const {
+    return solutionCost(goal);
+  }
+
+  // trace recording functions (solver threads)
+  void recordVertex(std::uint32_t id);
+  void recordRewire(std::uint32_t id);
+  void recordSolution(std::uint32_t id);
+  void recordPrune(std::uint32_t id);
+  void recordEdge(std::uint32_t id1, std::uint32_t id2);
+
+  // replay helpers (UI thread)
+  std::size_t replayBin(const sf::Vector2f &v) const;
+  void updateReplayMaxEdge(std::uint32_t id);
+  void updateTreeLine(std::uint32_t id);
 
   virtual void renderGui();
 
@@ -77,6 +153,28 @@ class SamplingBased : public State {
   // sampling-based planners
   virtual void updatePlanner(bool &solved, Vertex &start, Vertex &goal) = 0;
 
+  // planners returning true run updatePlanner() from several workers at
+  // once and must synchronize their own tree updates
+  virtual bool supportsParallelGrowth() const { return false; }
+
+  // planners returning true answer a moved start or goal of a solved query
+  // through requery() on the UI thread, without planning again
+  virtual bool supportsRequery() const { return false; }
+  virtual void requery() {}
+
+  // planners returning true keep their tree when the goal of a solved query
+  // moves, reconnectGoal() links the new goal into it on the UI thread
+  virtual bool supportsGoalReuse() const { return false; }
+  virtual void reconnectGoal(Vertex &goal) {}
+
+  // planners returning true keep improving a reused tree, the run resumes
+  // through resumePlanner() instead of initPlanner()
+  virtual bool refinesSolution() const { return false; }
+  virtual void resumePlanner() {}
+
+  // planners returning true draw the goal with probability goal_bias_
+  virtual bool supportsGoalBias() const { return false; }
+
   // main algorithm function (runs in separate thread)
   void solveConcurrently(std::shared_ptr<Vertex> start_point,
                          std::shared_ptr<Vertex> goal_point,
@@ -92,28 +190,136 @@ class SamplingBased : public State {
   unsigned int obst_size_;
   int map_width_;
   int map_height_;
-  std::vector<std::shared_ptr<sf::RectangleShape>> obstacles_;
 
   /**
-   * @brief Random number generator
+   * @brief Obstacles in map pixels, used for collision checks & picking
+   */
+  ObstacleSet obstacles_;
+  // bumped whenever the obstacles change
+  unsigned int obstacles_revision_{0u};
+  // all obstacles as triangles in map pixels, rebuilt with obstacles_
+  sf::VertexArray obstacle_triangles_;
+
+  // obstacle editing, one of OBSTACLE_TOOLS
+  int obstacle_tool_;
+  int square_size_;
+  int no_of_random_obstacles_;
+  // corner of the rectangle being dragged & corners of the open polygon
+  bool is_dragging_;
+  sf::Vector2f drag_start_;
+  std::vector<float> polygon_xs_, polygon_ys_;
+
+  /**
+   * @brief Random number generator, reseeded at the start of every run
    */
   std::mt19937 rn_gen_;
 
+  /**
+   * @brief Seed of the runs, 0 draws a new one every run
+   */
+  int seed_;
+  std::uint32_t run_seed_;
+
+  /**
+   * @brief Sample stream of the workers, one of SAMPLER
+   */
+  int sampler_;
+
+  /**
+   * @brief Probability of sampling the goal instead of the stream
+   */
+  double goal_bias_;
+
   // planner related
-  // vertices & edges
-  std::vector<std::shared_ptr<Vertex>> vertices_;
-  std::vector<std::pair<std::shared_ptr<Vertex>, std::shared_ptr<Vertex>>>
-      edges_;
+  // tree vertices, grown on the solver thread under mutex_
+  VertexArena vertices_;
   std::shared_ptr<Vertex> start_vertex_;
   std::shared_ptr<Vertex> goal_vertex_;
 
+  /**
+   * @brief Spatial index over vertices_ (solver threads)
+   * Queries take nn_mutex_ shared, insertions take it exclusively.
+   */
+  std::unique_ptr<NearestNeighbors> nn_;
+  std::shared_mutex nn_mutex_;
+  int nn_backend_;
+
+  /**
+   * @brief State owned by each worker growing the tree
+   */
+  struct WorkerState {
+    std::mt19937 rn_gen;
+    // points are pre-generated in batches, next_sample indexes the buffer
+    std::unique_ptr<SampleStream> stream;
+    std::vector<double> sample_xs, sample_ys;
+    std::size_t next_sample{0u};
+    // scratch buffers of the neighbourhood queries
+    std::vector<std::uint32_t> near_ids;
+    std::vector<double> near_costs;
+    std::vector<std::uint8_t> near_flags;
+  };
+  std::vector<WorkerState> workers_;
+  // index into workers_ of the calling solver thread
+  static thread_local std::size_t worker_index_;
+  WorkerState &worker() { return workers_[worker_index_]; }
+
+  /**
+   * @brief Number of workers growing the tree, if the planner supports it
+   */
+  int no_of_threads_;
+
+  // replayed tree, normalized positions & parent indices (UI thread)
+  std::vector<sf::Vector2f> replay_vertices_;
+  std::vector<std::uint32_t> replay_parents_;
+  std::uint32_t replay_solution_;
+  // replayed vertex ids per bin & the longest replayed edge (normalized)
+  std::vector<std::vector<std::uint32_t>> replay_bins_;
+  float replay_max_edge_;
+
+  // replayed tree as lines, two vertices per tree vertex: the vertex & its
+  // parent in normalized map coordinates, patched in place on rewires
+  sf::VertexArray tree_lines_;
+  // replayed roadmap edges, in the same coordinates as tree_lines_
+  sf::VertexArray roadmap_lines_;
+
+  // batched primitives of the planning scene, reused across frames
+  sf::VertexArray edge_vertices_;
+  sf::VertexArray point_vertices_;
+  // last frame that drew a collapsed edge into each pixel
+  std::vector<std::uint32_t> pixel_frames_;
+  std::uint32_t frame_no_{0u};
+
   /**
    * @brief Maximum number of iterations to run the algorithm
    */
   int max_iterations_;
 
-  std::mutex iter_no_mutex_;
-  unsigned int curr_iter_no_{0u};
+  /**
+   * @brief Iterations taken so far
+   * Only the uniqueness of the claimed numbers matters, the tree is
+   * synchronized by its own locks, so all accesses are relaxed.
+   */
+  std::atomic<unsigned int> curr_iter_no_{0u};
+
+  // iterations the run may take, grows by max_iterations_ on every resume
+  unsigned int iteration_limit_{0u};
+
+  // planning rate, sampled by the UI while the planner runs
+  float run_time_{0.f};
+  float rate_timer_{0.f};
+  unsigned int rate_iter_no_{0u};
+  float iterations_per_sec_{0.f};
+  std::vector<float> rate_history_;
+
+  // serializes trace appends of parallel workers
+  std::mutex trace_mutex_;
+  // locks trace_mutex_ only if several workers grow the tree
+  std::unique_lock<std::mutex> lockTrace();
+  // false skips the trace, e.g. for benchmark runs
+  bool is_recording_;
+
+  // collision checks of the run, counted by the planners (UI reads this)
+  std::atomic<std::size_t> no_of_collision_checks_{0u};
 
   // MessageQueue Object
   std::shared_ptr<MessageQueue<bool>> message_queue_;
@@ -121,14 +327,20 @@ class SamplingBased : public State {
   // logic flags
   bool is_initialized_;
   bool is_solved_;
-  bool is_stopped_;
+  // the next run continues the tree of the last one
+  bool is_resuming_;
+  // set by the UI (release), polled by the workers (acquire)
+  std::atomic<bool> is_stopped_{false};
   bool disable_run_;
   bool disable_gui_parameters_;
 
-  // threads & mutex
-  std::thread t_;
-  bool thread_joined_;
+  // planning job running on the thread pool & mutex of the goal
+  std::future<void> solver_;
   std::mutex mutex_;
+
+  // runs copies of the planners on this map, stops them before they go
+  friend class Benchmark;
+  Benchmark benchmark_;
 };
 
 }  // namespace sampling_based
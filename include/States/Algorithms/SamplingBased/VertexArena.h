@@ -0,0 +1,224 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "Trace.h"
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+// id of a missing vertex (no parent, child or sibling)
+static constexpr std::uint32_t NO_VERTEX = Trace::NO_PARENT;
+
+/**
+ * @brief Contiguous structure-of-arrays store of tree vertices
+ * Vertices are addressed by 32-bit ids given in insertion order. Children
+ * are kept as intrusive singly linked lists, so a rewire only touches the
+ * vertices involved. Columns are sized to the capacity and clear() keeps
+ * it, so a tree regrown to a reserved size allocates nothing.
+ *
+ * Threading rule: within the reserved capacity, addReserved() may run on
+ * several threads at once. detach() & reparent() edit the same child lists
+ * without the stripe locks, so they must run while no other thread is in
+ * the arena, i.e. under the exclusive tree lock of the owner (tree_mutex_
+ * of RRT*, which then also takes it for its appends) or from a planner with
+ * a single worker. Debug builds assert that edits never overlap appends or
+ * other edits.
+ */
+class VertexArena {
+ public:
+  // columns, indexed by vertex id, valid below size()
+  std::vector<double> x, y;
+  // cost-to-come from the root
+  std::vector<double> cost;
+  std::vector<std::uint32_t> parent;
+  std::vector<std::uint32_t> first_child;
+  std::vector<std::uint32_t> next_sibling;
+
+  VertexArena() = default;
+  VertexArena(const VertexArena &) = delete;
+  VertexArena &operator=(const VertexArena &) = delete;
+
+  /**
+   * @brief Number of ids handed out, may include vertices still being added
+   * by other threads
+   */
+  std::size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+  std::size_t capacity() const { return x.size(); }
+
+  void clear() { size_.store(0u, std::memory_order_relaxed); }
+
+  /**
+   * @brief Drop the vertices from id n on, not thread-safe
+   * Remaining vertices must not link to the dropped ones.
+   */
+  void truncate(std::size_t n) {
+    if (n < size()) size_.store(n, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Grow the columns to hold n vertices, not thread-safe
+   */
+  void reserve(std::size_t n) {
+    if (n <= capacity()) return;
+    x.resize(n);
+    y.resize(n);
+    cost.resize(n);
+    parent.resize(n);
+    first_child.resize(n);
+    next_sibling.resize(n);
+  }
+
+  /**
+   * @brief Append a vertex and link it to its parent, not thread-safe
+   * @return Id of the new vertex
+   */
+  std::uint32_t add(double vx, double vy, std::uint32_t p, double c) {
+    if (size() == capacity()) reserve(std::max<std::size_t>(64u, 2u * size()));
+    return addReserved(vx, vy, p, c);
+  }
+
+  /**
+   * @brief Append a vertex within the reserved capacity, thread-safe
+   * Ids are claimed without locking, linking into the child list of the
+   * parent only locks the stripe of the parent. The vertex may be read by
+   * other threads once it is published, e.g. through a spatial index.
+   * @return Id of the new vertex, NO_VERTEX if the arena is full
+   */
+  std::uint32_t addReserved(double vx, double vy, std::uint32_t p, double c) {
+#ifndef NDEBUG
+    const InProgress append(no_of_appends_);
+    assert(no_of_edits_.load() == 0 && "vertex added during a tree edit");
+#endif
+    const std::size_t slot = size_.fetch_add(1u, std::memory_order_relaxed);
+    if (slot >= capacity()) {
+      size_.fetch_sub(1u, std::memory_order_relaxed);
+      return NO_VERTEX;
+    }
+    const std::uint32_t id = static_cast<std::uint32_t>(slot);
+    x[id] = vx;
+    y[id] = vy;
+    cost[id] = c;
+    parent[id] = p;
+    first_child[id] = NO_VERTEX;
+    if (p != NO_VERTEX) {
+      std::lock_guard<std::mutex> lock(stripes_[p % LOCK_STRIPES]);
+      link(p, id);
+    } else {
+      next_sibling[id] = NO_VERTEX;
+    }
+    return id;
+  }
+
+  /**
+   * @brief Cut a vertex & its subtree off its parent
+   * Needs the arena to itself, see the threading rule of the class.
+   */
+  void detach(std::uint32_t id) {
+#ifndef NDEBUG
+    const InProgress edit(no_of_edits_);
+    assertExclusive();
+#endif
+    if (parent[id] == NO_VERTEX) return;
+    unlink(parent[id], id);
+    parent[id] = NO_VERTEX;
+  }
+
+  /**
+   * @brief Move a vertex under a new parent with a new cost-to-come
+   * A root vertex may be moved as well. The cost difference is pushed down
+   * the whole subtree of the vertex.
+   * Needs the arena to itself, see the threading rule of the class. The
+   * owner's lock also serializes it against readers of parents & costs.
+   */
+  void reparent(std::uint32_t id, std::uint32_t new_parent, double new_cost) {
+#ifndef NDEBUG
+    const InProgress edit(no_of_edits_);
+    assertExclusive();
+#endif
+    if (parent[id] != NO_VERTEX) unlink(parent[id], id);
+    parent[id] = new_parent;
+    link(new_parent, id);
+
+    const double delta = new_cost - cost[id];
+    cost[id] = new_cost;
+
+    // iterative traversal, deep trees never recurse
+    stack_.clear();
+    stack_.push_back(first_child[id]);
+    while (!stack_.empty()) {
+      std::uint32_t current = stack_.back();
+      stack_.pop_back();
+      // walk the siblings, descend into the children later
+      while (current != NO_VERTEX) {
+        cost[current] += delta;
+        if (first_child[current] != NO_VERTEX) {
+          stack_.push_back(first_child[current]);
+        }
+        current = next_sibling[current];
+      }
+    }
+  }
+
+ private:
+  void link(std::uint32_t p, std::uint32_t child) {
+    next_sibling[child] = first_child[p];
+    first_child[p] = child;
+  }
+
+  void unlink(std::uint32_t p, std::uint32_t child) {
+    if (first_child[p] == child) {
+      first_child[p] = next_sibling[child];
+      return;
+    }
+    std::uint32_t current = first_child[p];
+    while (current != NO_VERTEX) {
+      if (next_sibling[current] == child) {
+        next_sibling[current] = next_sibling[child];
+        return;
+      }
+      current = next_sibling[current];
+    }
+  }
+
+#ifndef NDEBUG
+  // counts a call while it is in progress
+  class InProgress {
+   public:
+    explicit InProgress(std::atomic<int> &calls) : calls_{calls} {
+      calls_.fetch_add(1);
+    }
+    ~InProgress() { calls_.fetch_sub(1); }
+
+   private:
+    std::atomic<int> &calls_;
+  };
+
+  void assertExclusive() const {
+    assert(no_of_edits_.load() == 1 && no_of_appends_.load() == 0 &&
+           "tree edit without the exclusive tree lock");
+  }
+
+  // appends & edits in progress, checked against the threading rule
+  std::atomic<int> no_of_appends_{0};
+  std::atomic<int> no_of_edits_{0};
+#endif
+
+  static constexpr std::size_t LOCK_STRIPES = 64u;
+
+  std::atomic<std::size_t> size_{0u};
+  // guard the child lists of concurrently added vertices
+  std::array<std::mutex, LOCK_STRIPES> stripes_;
+  // scratch stack of the subtree traversals
+  std::vector<std::uint32_t> stack_;
+};
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
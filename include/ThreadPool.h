@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace path_finding_visualizer {
+
+/**
+ * @brief Application-wide work-stealing task scheduler
+ * Every worker owns a task deque. Tasks submitted from a worker go to the
+ * back of its own deque and are popped LIFO, tasks submitted from other
+ * threads are spread round-robin. Idle workers steal from the front of the
+ * other deques. Threads waiting for a parallelFor() only help with the
+ * chunks of that call, so nested parallel work never deadlocks the pool and
+ * a waiter never picks up an unrelated long job.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @param no_of_threads Number of workers, 0 picks the hardware concurrency
+   */
+  explicit ThreadPool(unsigned no_of_threads = 0u);
+
+  // Destructor, waits for the queued tasks to finish
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  std::size_t size() const { return workers_.size(); }
+
+  /**
+   * @brief Queue a task
+   * @return Future holding the result of the task
+   */
+  template <typename F>
+  auto submit(F &&f) -> std::future<std::invoke_result_t<F>> {
+    using R = std::invoke_result_t<F>;
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+    std::future<R> result = task->get_future();
+    push([task]() { (*task)(); }, nullptr);
+    return result;
+  }
+
+  /**
+   * @brief Run f(i) for every i in [begin, end) across the pool
+   * The calling thread takes part and returns once all indices are done.
+   * @param grain Minimum number of indices per task
+   */
+  template <typename F>
+  void parallelFor(std::size_t begin, std::size_t end, F &&f,
+                   std::size_t grain = 1u) {
+    if (begin >= end) return;
+    const std::size_t n = end - begin;
+    // a few chunks per thread keep the load balanced without tiny tasks
+    const std::size_t max_chunks = 4u * (size() + 1u);
+    const std::size_t chunks = std::min(
+        max_chunks,
+        std::max<std::size_t>(1u, n / std::max<std::size_t>(grain, 1u)));
+    const std::size_t chunk_size = (n + chunks - 1u) / chunks;
+
+    std::atomic<std::size_t> remaining{chunks};
+    auto run_chunk = [&](std::size_t c) {
+      const std::size_t first = begin + c * chunk_size;
+      const std::size_t last = std::min(end, first + chunk_size);
+      for (std::size_t i = first; i < last; ++i) f(i);
+      remaining.fetch_sub(1u, std::memory_order_release);
+    };
+
+    // the chunks are tagged with this call, unique while it runs
+    const void *group = &remaining;
+    for (std::size_t c = 1u; c < chunks; ++c) {
+      push([&run_chunk, c]() { run_chunk(c); }, group);
+    }
+    run_chunk(0u);
+
+    // help with the own chunks instead of blocking a worker
+    while (remaining.load(std::memory_order_acquire) > 0u) {
+      if (!runGroupTask(group)) std::this_thread::yield();
+    }
+  }
+
+ private:
+  /**
+   * @brief Queued task, group is the parallelFor() call of a chunk or
+   * nullptr for submitted tasks
+   */
+  struct Task {
+    std::function<void()> run;
+    const void *group;
+  };
+
+  struct WorkQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void push(std::function<void()> task, const void *group);
+  // take a task of the group, any task if group is nullptr
+  bool pop(std::size_t index, Task &task, const void *group);
+  bool steal(std::size_t index, Task &task, const void *group);
+  // run one queued chunk of a parallelFor() call on the calling thread
+  bool runGroupTask(const void *group);
+  void workerLoop(std::size_t index);
+
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<std::size_t> next_queue_{0u};
+  // queued tasks not yet taken by a thread
+  std::atomic<std::size_t> pending_{0u};
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  bool stop_{false};
+};
+
+}  // namespace path_finding_visualizer
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace path_finding_visualizer {
+
+/**
+ * @brief Kind of planner event recorded in a trace
+ */
+enum class TraceEventType : std::uint8_t {
+  EXPAND,         // graph-based: cell popped from the frontier
+  PUSH_FRONTIER,  // graph-based: cell pushed into the frontier with parent
+  ADD_VERTEX,     // sampling-based: vertex added to the tree with parent
+  REWIRE,         // sampling-based: parent of a vertex changed
+  SOLUTION,       // goal is connected through the given cell/vertex
+  PRUNE,          // sampling-based: vertex removed from the tree
+  ADD_EDGE,       // sampling-based: roadmap edge between vertex & parent
+  COUNT
+};
+
+/**
+ * @brief Compact planner event (16 bytes)
+ * Vertex positions are quantized to 16 bits over the unit square, which is
+ * well below a pixel even on the largest maps.
+ */
+struct TraceEvent {
+  std::uint32_t id;
+  std::uint32_t parent;
+  std::uint16_t x, y;
+  TraceEventType type;
+};
+
+/**
+ * @brief Chunked, append-only buffer of planner events
+ * A single solver thread appends events at full speed while the UI thread
+ * reads the published prefix to animate it. Every published prefix is a
+ * consistent state of the planner, readers never lock. Chunks & outgrown
+ * chunk directories are never moved or freed until clear(), so a reader
+ * holding an older directory still finds every chunk it can see.
+ */
+class Trace {
+ public:
+  static constexpr std::size_t CHUNK_SIZE = 4096u;
+  static constexpr std::uint32_t NO_PARENT = 0xFFFFFFFFu;
+
+  Trace() { clear(); }
+
+  /**
+   * @brief Drop all events, must not be called while a solver is appending
+   */
+  void clear() {
+    chunks_.clear();
+    directories_.clear();
+    directory_.store(nullptr, std::memory_order_relaxed);
+    tail_ = nullptr;
+    for (auto& c : counts_) c.store(0u, std::memory_order_relaxed);
+    size_.store(0u, std::memory_order_release);
+  }
+
+  void setDimensions(std::uint32_t width, std::uint32_t height) {
+    width_ = width;
+    height_ = height;
+  }
+
+  /**
+   * @brief Append an event (solver thread only)
+   */
+  void append(const TraceEvent& e) {
+    const std::size_t idx = size_.load(std::memory_order_relaxed);
+    const std::size_t offset = idx % CHUNK_SIZE;
+    if (offset == 0u) addChunk();
+    tail_[offset] = e;
+    counts_[static_cast<std::size_t>(e.type)].fetch_add(
+        1u, std::memory_order_relaxed);
+    // publish the event to readers
+    size_.store(idx + 1u, std::memory_order_release);
+  }
+
+  /**
+   * @brief Number of published events
+   */
+  std::size_t size() const { return size_.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Number of published events of a particular type
+   */
+  std::size_t count(TraceEventType type) const {
+    return counts_[static_cast<std::size_t>(type)].load(
+        std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Allocated memory in bytes
+   */
+  std::size_t bytes() const {
+    return (size() + CHUNK_SIZE - 1u) / CHUNK_SIZE * CHUNK_SIZE *
+           sizeof(TraceEvent);
+  }
+
+  /**
+   * @brief Visit published events in [begin, end)
+   */
+  template <typename F>
+  void forEach(std::size_t begin, std::size_t end, F&& f) const {
+    end = std::min(end, size());
+    if (begin >= end) return;
+
+    // the directory seen after size() holds every published chunk
+    const Directory* directory = directory_.load(std::memory_order_acquire);
+    for (std::size_t i = begin; i < end; ++i) {
+      f(directory->chunks[i / CHUNK_SIZE][i % CHUNK_SIZE]);
+    }
+  }
+
+  /**
+   * @brief Write the published events to a binary file
+   * Layout, all integers little-endian: "PFVTRACE", u32 version, u32 event
+   * size, u32 width, u32 height, u64 event count, followed by the events,
+   * each u32 id, u32 parent, u16 x, u16 y, u8 type (13 bytes, no padding).
+   * @return true on success
+   */
+  bool save(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) return false;
+
+    const std::size_t n = size();
+    out.write("PFVTRACE", 8);
+    writeLittleEndian(out, std::uint32_t{2u}, 4u);
+    writeLittleEndian(out, EVENT_FILE_SIZE, 4u);
+    writeLittleEndian(out, width_, 4u);
+    writeLittleEndian(out, height_, 4u);
+    writeLittleEndian(out, static_cast<std::uint64_t>(n), 8u);
+    forEach(0u, n, [&out](const TraceEvent& e) {
+      writeLittleEndian(out, e.id, 4u);
+      writeLittleEndian(out, e.parent, 4u);
+      writeLittleEndian(out, e.x, 2u);
+      writeLittleEndian(out, e.y, 2u);
+      writeLittleEndian(out, static_cast<std::uint8_t>(e.type), 1u);
+    });
+    return static_cast<bool>(out);
+  }
+
+  static std::uint16_t quantize(double v) {
+    return static_cast<std::uint16_t>(
+        std::lround(std::min(std::max(v, 0.0), 1.0) * 65535.0));
+  }
+
+  static float dequantize(std::uint16_t v) {
+    return static_cast<float>(v) / 65535.f;
+  }
+
+ private:
+  /**
+   * @brief Chunk pointers by chunk index, replaced by a copy of twice the
+   * capacity once full
+   */
+  struct Directory {
+    std::size_t capacity;
+    std::unique_ptr<const TraceEvent*[]> chunks;
+  };
+
+  // bytes of an event in a saved file
+  static constexpr std::uint32_t EVENT_FILE_SIZE = 13u;
+
+  // field by field, independent of the struct layout & host byte order
+  static void writeLittleEndian(std::ofstream& out, std::uint64_t v,
+                                std::size_t no_of_bytes) {
+    char bytes[8];
+    for (std::size_t i = 0u; i < no_of_bytes; ++i) {
+      bytes[i] = static_cast<char>((v >> (8u * i)) & 0xFFu);
+    }
+    out.write(bytes, static_cast<std::streamsize>(no_of_bytes));
+  }
+
+  // allocate the chunk of the next event (solver thread only)
+  void addChunk() {
+    chunks_.emplace_back(new TraceEvent[CHUNK_SIZE]);
+    tail_ = chunks_.back().get();
+
+    const std::size_t n = chunks_.size();
+    Directory* directory = directory_.load(std::memory_order_relaxed);
+    if (directory == nullptr || directory->capacity < n) {
+      const std::size_t capacity = std::max<std::size_t>(64u, 2u * n);
+      directories_.push_back(std::unique_ptr<Directory>(
+          new Directory{capacity, std::unique_ptr<const TraceEvent*[]>(
+                                      new const TraceEvent*[capacity])}));
+      Directory* grown = directories_.back().get();
+      for (std::size_t c = 0u; c + 1u < n; ++c) {
+        grown->chunks[c] = directory->chunks[c];
+      }
+      directory = grown;
+    }
+    directory->chunks[n - 1u] = tail_;
+    // readers reach the new slot only through a later size_ release
+    directory_.store(directory, std::memory_order_release);
+  }
+
+  // owned by the solver thread
+  std::vector<std::unique_ptr<TraceEvent[]>> chunks_;
+  std::vector<std::unique_ptr<Directory>> directories_;
+  TraceEvent* tail_{nullptr};
+  // latest directory, read by the UI thread
+  std::atomic<Directory*> directory_{nullptr};
+  std::atomic<std::size_t> size_{0u};
+  std::array<std::atomic<std::size_t>,
+             static_cast<std::size_t>(TraceEventType::COUNT)>
+      counts_;
+  std::uint32_t width_{0u};
+  std::uint32_t height_{0u};
+};
+
+}  // namespace path_finding_visualizer
@@ -1,10 +1,16 @@
 #include "Game.h"
 
+#include <algorithm>
+
 #include "States/Algorithms/GraphBased/ASTAR/ASTAR.h"
 #include "States/Algorithms/GraphBased/BFS/BFS.h"
 #include "States/Algorithms/GraphBased/DFS/DFS.h"
 #include "States/Algorithms/GraphBased/DIJKSTRA/DIJKSTRA.h"
+#include "States/Algorithms/SamplingBased/BIT_STAR/BIT_STAR.h"
+#include "States/Algorithms/SamplingBased/INFORMED_RRT_STAR/INFORMED_RRT_STAR.h"
+#include "States/Algorithms/SamplingBased/PRM_STAR/PRM_STAR.h"
 #include "States/Algorithms/SamplingBased/RRT/RRT.h"
+#include "States/Algorithms/SamplingBased/RRT_CONNECT/RRT_CONNECT.h"
 #include "States/Algorithms/SamplingBased/RRT_STAR/RRT_STAR.h"
 
 using bfs_state_type = path_finding_visualizer::graph_based::BFS;
@@ -13,6 +19,12 @@ using dijkstra_state_type = path_finding_visualizer::graph_based::DIJKSTRA;
 using astar_state_type = path_finding_visualizer::graph_based::ASTAR;
 using rrt_state_type = path_finding_visualizer::sampling_based::RRT;
 using rrtstar_state_type = path_finding_visualizer::sampling_based::RRT_STAR;
+using rrtconnect_state_type =
+    path_finding_visualizer::sampling_based::RRT_CONNECT;
+using informedrrtstar_state_type =
+    path_finding_visualizer::sampling_based::INFORMED_RRT_STAR;
+using prmstar_state_type = path_finding_visualizer::sampling_based::PRM_STAR;
+using bitstar_state_type = path_finding_visualizer::sampling_based::BIT_STAR;
 
 namespace path_finding_visualizer {
 
@@ -20,10 +32,15 @@ namespace path_finding_visualizer {
 Game::Game(sf::RenderWindow* window, sf::RenderTexture* render_texture)
     : window_{window}, render_texture_{render_texture}, disable_run_{false} {
   logger_panel_ = std::make_shared<gui::LoggerPanel>();
+  thread_pool_ = std::make_shared<ThreadPool>();
   curr_planner_ = GRAPH_BASED_PLANNERS[0];
   // manually add BFS for now
-  states_.push(std::make_unique<bfs_state_type>(logger_panel_));
+  states_.push(std::make_unique<bfs_state_type>(logger_panel_, thread_pool_));
   view_move_xy_.x = view_move_xy_.y = 0.f;
+  view_zoom_ = 1.f;
+  scene_size_ = sf::Vector2u(0u, 0u);
+  scene_revision_ = 0u;
+  scene_dirty_ = true;
   initGuiTheme();
 }
 
@@ -108,9 +125,11 @@ void Game::renderNewPlannerMenu() {
 void Game::renderRunMenu(ImGuiIO& io) {
   if (ImGui::BeginMenu("Run")) {
     {
-      if (disable_run_) ImGui::BeginDisabled();
+      const bool can_run =
+          !disable_run_ && (states_.empty() || states_.top()->canRun());
+      if (!can_run) ImGui::BeginDisabled();
       bool clicked = ImGui::MenuItem("Start Planning");
-      if (disable_run_) ImGui::EndDisabled();
+      if (!can_run) ImGui::EndDisabled();
       if (clicked) {
         logger_panel_->info("RUN button pressed. Planning started.");
         disable_run_ = true;
@@ -137,7 +156,6 @@ void Game::renderRunMenu(ImGuiIO& io) {
 
 void Game::render() {
   window_->clear();
-  render_texture_->clear(sf::Color::White);
 
   if (!states_.empty()) {
     // DOCKING STUFFS
@@ -242,6 +260,10 @@ void Game::render() {
       ImGui::Indent();
       ImGui::BulletText("Rapidly-exploring random trees (RRT)");
       ImGui::BulletText("RRT*");
+      ImGui::BulletText("RRT-Connect");
+      ImGui::BulletText("Informed RRT*");
+      ImGui::BulletText("PRM*");
+      ImGui::BulletText("Batch Informed Trees (BIT*)");
       ImGui::Unindent();
       ImGui::End();
     }
@@ -263,6 +285,7 @@ void Game::render() {
       ImGui::Text("Current Planner: %s", curr_planner_.c_str());
       ImGui::Spacing();
       ImGui::Spacing();
+      states_.top()->renderStats();
       ImGui::End();
     }
 
@@ -273,37 +296,71 @@ void Game::render() {
     ImGui::Begin("Planning Scene");
 
     const ImVec2 planning_scene_panel_size = ImGui::GetContentRegionAvail();
-    render_texture_->create(static_cast<unsigned>(planning_scene_panel_size.x),
-                            static_cast<unsigned>(planning_scene_panel_size.y));
-    render_texture_->clear(sf::Color::White);
+
+    // the render target is only reallocated when the panel is resized
+    const sf::Vector2u scene_size(
+        static_cast<unsigned>(planning_scene_panel_size.x),
+        static_cast<unsigned>(planning_scene_panel_size.y));
+    if (scene_size != scene_size_ && scene_size.x > 0u && scene_size.y > 0u) {
+      render_texture_->create(scene_size.x, scene_size.y);
+      scene_size_ = scene_size;
+      scene_dirty_ = true;
+    }
 
     sf::View view;
-    view.setSize(
-        sf::Vector2f(planning_scene_panel_size.x, planning_scene_panel_size.y));
+    view.setSize(sf::Vector2f(planning_scene_panel_size.x * view_zoom_,
+                              planning_scene_panel_size.y * view_zoom_));
     view.setCenter(
         sf::Vector2f((planning_scene_panel_size.x / 2.f) + view_move_xy_.x,
                      (planning_scene_panel_size.y / 2.f) + view_move_xy_.y));
-    render_texture_->setView(view);
-    states_.top()->renderScene(*render_texture_);
+
+    // skip the redraw when neither the planner state nor the view changed
+    const std::uint64_t scene_revision = states_.top()->sceneRevision();
+    if (scene_dirty_ || scene_revision != scene_revision_ ||
+        view.getCenter() != scene_view_.getCenter() ||
+        view.getSize() != scene_view_.getSize()) {
+      render_texture_->setView(view);
+      render_texture_->clear(sf::Color::White);
+      states_.top()->renderScene(*render_texture_);
+
+      scene_view_ = view;
+      scene_revision_ = scene_revision;
+      scene_dirty_ = false;
+    }
 
     ImGui::ImageButton(*render_texture_, 0);
 
     const bool is_hovered = ImGui::IsItemHovered();  // Hovered
     const bool is_active = ImGui::IsItemActive();    // Held
 
+    // mouse offset from the center of the planning scene panel
+    const ImVec2 image_min = ImGui::GetItemRectMin();
+    const ImVec2 mouse_offset(
+        io.MousePos.x - image_min.x - (planning_scene_panel_size.x / 2.f),
+        io.MousePos.y - image_min.y - (planning_scene_panel_size.y / 2.f));
+
     // move the planning scene around by dragging mouse Right-click
     if (is_hovered && ImGui::IsMouseDragging(ImGuiMouseButton_Right)) {
-      view_move_xy_.x -= io.MouseDelta.x;
-      view_move_xy_.y -= io.MouseDelta.y;
+      view_move_xy_.x -= io.MouseDelta.x * view_zoom_;
+      view_move_xy_.y -= io.MouseDelta.y * view_zoom_;
+    }
+
+    // zoom with the mouse wheel, keeping the point under the cursor fixed
+    if (is_hovered && io.MouseWheel != 0.f) {
+      const float new_zoom = std::min(
+          std::max(view_zoom_ * (io.MouseWheel > 0.f ? 1.f / 1.1f : 1.1f),
+                   0.05f),
+          1000.f);
+      view_move_xy_.x += mouse_offset.x * (view_zoom_ - new_zoom);
+      view_move_xy_.y += mouse_offset.y * (view_zoom_ - new_zoom);
+      view_zoom_ = new_zoom;
     }
 
     // Update the current mouse position in planning scene panel
-    ImVec2 canvas_p0 = ImGui::GetCursorScreenPos();
-    const ImVec2 origin(canvas_p0.x - view_move_xy_.x,
-                        canvas_p0.y - view_move_xy_.y);
-    mouse_pos_in_canvas_.x = io.MousePos.x - origin.x;
-    mouse_pos_in_canvas_.y =
-        io.MousePos.y - origin.y + planning_scene_panel_size.y;
+    mouse_pos_in_canvas_.x = (planning_scene_panel_size.x / 2.f) +
+                             view_move_xy_.x + mouse_offset.x * view_zoom_;
+    mouse_pos_in_canvas_.y = (planning_scene_panel_size.y / 2.f) +
+                             view_move_xy_.y + mouse_offset.y * view_zoom_;
 
     ImGui::End();
     ImGui::PopStyleVar();
@@ -388,22 +445,28 @@ void Game::initGuiTheme() {
 }
 
 void Game::setGraphBasedPlanner(const int id) {
+  // a new planner always needs a fresh planning scene
+  scene_dirty_ = true;
   switch (id) {
     case GRAPH_BASED_PLANNERS_IDS::BFS:
       // BFS
-      states_.push(std::make_unique<bfs_state_type>(logger_panel_));
+      states_.push(
+          std::make_unique<bfs_state_type>(logger_panel_, thread_pool_));
       break;
     case GRAPH_BASED_PLANNERS_IDS::DFS:
       // DFS
-      states_.push(std::make_unique<dfs_state_type>(logger_panel_));
+      states_.push(
+          std::make_unique<dfs_state_type>(logger_panel_, thread_pool_));
       break;
     case GRAPH_BASED_PLANNERS_IDS::DIJKSTRA:
       // Dijkstra
-      states_.push(std::make_unique<dijkstra_state_type>(logger_panel_));
+      states_.push(
+          std::make_unique<dijkstra_state_type>(logger_panel_, thread_pool_));
       break;
     case GRAPH_BASED_PLANNERS_IDS::AStar:
       // A-Star
-      states_.push(std::make_unique<astar_state_type>(logger_panel_));
+      states_.push(
+          std::make_unique<astar_state_type>(logger_panel_, thread_pool_));
       break;
     default:
       break;
@@ -411,16 +474,38 @@ void Game::setGraphBasedPlanner(const int id) {
 }
 
 void Game::setSamplingBasedPlanner(const int id) {
+  // a new planner always needs a fresh planning scene
+  scene_dirty_ = true;
   switch (id) {
     case SAMPLING_BASED_PLANNERS_IDS::RRT:
       // RRT
       states_.push(std::make_unique<rrt_state_type>(
-          logger_panel_, SAMPLING_BASED_PLANNERS[id]));
+          logger_panel_, thread_pool_, SAMPLING_BASED_PLANNERS[id]));
       break;
     case SAMPLING_BASED_PLANNERS_IDS::RRT_STAR:
       // RRTStar
       states_.push(std::make_unique<rrtstar_state_type>(
-          logger_panel_, SAMPLING_BASED_PLANNERS[id]));
+          logger_panel_, thread_pool_, SAMPLING_BASED_PLANNERS[id]));
+      break;
+    case SAMPLING_BASED_PLANNERS_IDS::RRT_CONNECT:
+      // RRT-Connect
+      states_.push(std::make_unique<rrtconnect_state_type>(
+          logger_panel_, thread_pool_, SAMPLING_BASED_PLANNERS[id]));
+      break;
+    case SAMPLING_BASED_PLANNERS_IDS::INFORMED_RRT_STAR:
+      // Informed RRT*
+      states_.push(std::make_unique<informedrrtstar_state_type>(
+          logger_panel_, thread_pool_, SAMPLING_BASED_PLANNERS[id]));
+      break;
+    case SAMPLING_BASED_PLANNERS_IDS::PRM_STAR:
+      // PRM*
+      states_.push(std::make_unique<prmstar_state_type>(
+          logger_panel_, thread_pool_, SAMPLING_BASED_PLANNERS[id]));
+      break;
+    case SAMPLING_BASED_PLANNERS_IDS::BIT_STAR:
+      // BIT*
+      states_.push(std::make_unique<bitstar_state_type>(
+          logger_panel_, thread_pool_, SAMPLING_BASED_PLANNERS[id]));
       break;
     default:
       break;
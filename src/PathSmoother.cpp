@@ -0,0 +1,232 @@
+#include "PathSmoother.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+namespace path_finding_visualizer {
+
+namespace {
+// shortcuts proposed & checked together in a round
+constexpr std::size_t SHORTCUTS_PER_ROUND = 64u;
+// rounds in a row without an applied shortcut before the stage ends
+constexpr int MAX_IDLE_ROUNDS = 4;
+// control points of a spline piece repeated this often make it straight
+constexpr int MAX_MULTIPLICITY = 3;
+
+using Clock = std::chrono::steady_clock;
+
+struct Shortcut {
+  std::size_t first, last;
+  // path length saved by going straight from first to last
+  double saving;
+};
+
+double distance(const PathPoint &a, const PathPoint &b) {
+  return std::hypot(a.x - b.x, a.y - b.y);
+}
+
+// point of the uniform cubic B-spline piece with control points p0..p3
+PathPoint splinePoint(const PathPoint &p0, const PathPoint &p1,
+                      const PathPoint &p2, const PathPoint &p3, double t) {
+  const double t2 = t * t, t3 = t2 * t, u = 1.0 - t;
+  const double b0 = u * u * u / 6.0;
+  const double b1 = (3.0 * t3 - 6.0 * t2 + 4.0) / 6.0;
+  const double b2 = (-3.0 * t3 + 3.0 * t2 + 3.0 * t + 1.0) / 6.0;
+  const double b3 = t3 / 6.0;
+  return {b0 * p0.x + b1 * p1.x + b2 * p2.x + b3 * p3.x,
+          b0 * p0.y + b1 * p1.y + b2 * p2.y + b3 * p3.y};
+}
+}  // namespace
+
+PathSmoother::PathSmoother(std::shared_ptr<ThreadPool> thread_pool)
+    : thread_pool_{thread_pool} {}
+
+double PathSmoother::length(const std::vector<PathPoint> &path) {
+  double l = 0.0;
+  for (std::size_t i = 1u; i < path.size(); ++i) {
+    l += distance(path[i - 1u], path[i]);
+  }
+  return l;
+}
+
+SmoothingStats PathSmoother::smooth(std::vector<PathPoint> &path,
+                                    const SegmentCheck &is_free,
+                                    double resolution, double time_budget_ms,
+                                    bool spline, std::uint32_t seed) const {
+  const auto t0 = Clock::now();
+  const auto deadline =
+      t0 + std::chrono::duration_cast<Clock::duration>(
+               std::chrono::duration<double, std::milli>(time_budget_ms));
+  SmoothingStats stats;
+  stats.initial_cost = length(path);
+  std::atomic<std::size_t> no_of_checks{0u};
+
+  // randomized shortcuts, checked in parallel one round at a time
+  std::mt19937 rn_gen(seed);
+  std::vector<Shortcut> candidates;
+  std::vector<std::uint8_t> is_valid;
+  std::vector<double> prefix;
+  std::vector<std::uint8_t> is_removed;
+  int idle_rounds = 0;
+  while (path.size() > 2u && idle_rounds < MAX_IDLE_ROUNDS) {
+    if (Clock::now() >= deadline) {
+      stats.budget_exceeded = true;
+      break;
+    }
+    const std::size_t n = path.size();
+
+    // path length up to every point
+    prefix.assign(n, 0.0);
+    for (std::size_t i = 1u; i < n; ++i) {
+      prefix[i] = prefix[i - 1u] + distance(path[i - 1u], path[i]);
+    }
+
+    candidates.clear();
+    std::uniform_int_distribution<std::size_t> first_dis(0u, n - 3u);
+    for (std::size_t k = 0u; k < SHORTCUTS_PER_ROUND; ++k) {
+      const std::size_t i = first_dis(rn_gen);
+      const std::size_t j =
+          std::uniform_int_distribution<std::size_t>(i + 2u, n - 1u)(rn_gen);
+      const double saving = prefix[j] - prefix[i] - distance(path[i], path[j]);
+      if (saving > 1e-12) candidates.push_back({i, j, saving});
+    }
+
+    is_valid.assign(candidates.size(), 0u);
+    thread_pool_->parallelFor(0u, candidates.size(), [&](std::size_t k) {
+      is_valid[k] =
+          is_free(path[candidates[k].first], path[candidates[k].last]) ? 1u
+                                                                       : 0u;
+    });
+    no_of_checks += candidates.size();
+
+    // the largest savings win, applied shortcuts only share their end points
+    std::size_t no_of_valid = 0u;
+    for (std::size_t k = 0u; k < candidates.size(); ++k) {
+      if (is_valid[k]) candidates[no_of_valid++] = candidates[k];
+    }
+    candidates.resize(no_of_valid);
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Shortcut &a, const Shortcut &b) {
+                return a.saving > b.saving;
+              });
+    is_removed.assign(n, 0u);
+    std::size_t applied = 0u;
+    for (const Shortcut &s : candidates) {
+      if (std::any_of(is_removed.begin() + s.first,
+                      is_removed.begin() + s.last + 1u,
+                      [](std::uint8_t r) { return r != 0u; })) {
+        continue;
+      }
+      std::fill(is_removed.begin() + s.first + 1u, is_removed.begin() + s.last,
+                1u);
+      ++applied;
+    }
+
+    if (applied == 0u) {
+      ++idle_rounds;
+      continue;
+    }
+    idle_rounds = 0;
+    stats.no_of_shortcuts += applied;
+    std::size_t kept = 0u;
+    for (std::size_t i = 0u; i < n; ++i) {
+      if (!is_removed[i]) path[kept++] = path[i];
+    }
+    path.resize(kept);
+  }
+  stats.shortcut_cost = length(path);
+
+  // B-spline through the shortcut polyline, the end points are tripled so
+  // that the curve starts & ends on them
+  if (spline && path.size() > 2u && !stats.budget_exceeded) {
+    const std::size_t n = path.size();
+    std::vector<int> multiplicity(n, 1);
+    multiplicity.front() = multiplicity.back() = MAX_MULTIPLICITY;
+    // path point behind every control point
+    std::vector<std::size_t> owners;
+    std::vector<std::vector<PathPoint>> pieces;
+    std::vector<std::uint8_t> is_piece_free;
+
+    bool converged = false;
+    while (!converged) {
+      if (Clock::now() >= deadline) {
+        stats.budget_exceeded = true;
+        break;
+      }
+      owners.clear();
+      for (std::size_t i = 0u; i < n; ++i) {
+        owners.insert(owners.end(), multiplicity[i], i);
+      }
+      const std::size_t no_of_pieces = owners.size() - 3u;
+      pieces.resize(no_of_pieces);
+      is_piece_free.assign(no_of_pieces, 1u);
+
+      thread_pool_->parallelFor(0u, no_of_pieces, [&](std::size_t s) {
+        const PathPoint &p0 = path[owners[s]];
+        const PathPoint &p1 = path[owners[s + 1u]];
+        const PathPoint &p2 = path[owners[s + 2u]];
+        const PathPoint &p3 = path[owners[s + 3u]];
+        // the piece is never longer than its control polygon
+        const double control_length =
+            distance(p0, p1) + distance(p1, p2) + distance(p2, p3);
+        const std::size_t steps =
+            std::max<std::size_t>(1u, static_cast<std::size_t>(std::ceil(
+                                          control_length / resolution)));
+
+        std::vector<PathPoint> &points = pieces[s];
+        points.clear();
+        for (std::size_t k = 0u; k <= steps; ++k) {
+          points.push_back(
+              splinePoint(p0, p1, p2, p3, static_cast<double>(k) / steps));
+        }
+        std::size_t k = 1u;
+        for (; k <= steps; ++k) {
+          if (!is_free(points[k - 1u], points[k])) {
+            is_piece_free[s] = 0u;
+            break;
+          }
+        }
+        no_of_checks += std::min(k, steps);
+      });
+
+      // colliding pieces are pulled toward their control polygon, once all
+      // of their control points are tripled they run along the polyline
+      converged = true;
+      bool is_stuck = false;
+      for (std::size_t s = 0u; s < no_of_pieces; ++s) {
+        if (is_piece_free[s]) continue;
+        converged = false;
+        bool raised = false;
+        for (std::size_t q = s; q < s + 4u; ++q) {
+          int &m = multiplicity[owners[q]];
+          if (m < MAX_MULTIPLICITY) {
+            ++m;
+            raised = true;
+          }
+        }
+        if (!raised) is_stuck = true;
+      }
+      // the polyline itself collides there, keep it as it is
+      if (is_stuck) break;
+    }
+
+    if (converged) {
+      path.clear();
+      for (const std::vector<PathPoint> &points : pieces) {
+        path.insert(path.end(), points.begin(), points.end() - 1);
+      }
+      path.push_back(pieces.back().back());
+    }
+  }
+
+  stats.final_cost = length(path);
+  stats.no_of_collision_checks = no_of_checks.load();
+  stats.time_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+  return stats;
+}
+
+}  // namespace path_finding_visualizer
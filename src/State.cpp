@@ -1,9 +1,25 @@
 #include "State.h"
 
+#include <cstdio>
+
 namespace path_finding_visualizer {
 
-State::State(std::shared_ptr<gui::LoggerPanel> logger_panel)
-    : logger_panel_{logger_panel} {}
+State::State(std::shared_ptr<gui::LoggerPanel> logger_panel,
+             std::shared_ptr<ThreadPool> thread_pool)
+    : logger_panel_{logger_panel},
+      thread_pool_{thread_pool},
+      replay_cursor_{0u},
+      replay_budget_{0.0},
+      replay_speed_{1000.f},
+      replay_paused_{false},
+      scene_revision_{0u},
+      path_smoother_{thread_pool},
+      smooth_path_{true},
+      smooth_spline_{true},
+      smoothing_budget_ms_{50.0} {
+  std::snprintf(trace_filename_, sizeof(trace_filename_), "%s",
+                "planner_trace.pfvt");
+}
 
 State::~State() {}
 
@@ -12,4 +28,176 @@ void State::updateMousePosition(const ImVec2& mousePos) {
   mousePositionWindow_.y = mousePos.y;
 }
 
-}  // namespace path_finding_visualizer
\ No newline at end of file
+void State::resetTrace() {
+  trace_.clear();
+  replay_cursor_ = 0u;
+  replay_budget_ = 0.0;
+  resetReplay();
+  markSceneChanged();
+}
+
+void State::seekReplay(std::size_t target) {
+  target = std::min(target, trace_.size());
+  if (target == replay_cursor_) return;
+  markSceneChanged();
+
+  // events are only applied forward, so scrubbing backward replays from start
+  if (target < replay_cursor_) {
+    resetReplay();
+    replay_cursor_ = 0u;
+  }
+
+  if (target > replay_cursor_) {
+    trace_.forEach(replay_cursor_, target,
+                   [this](const TraceEvent& e) { applyTraceEvent(e); });
+    replay_cursor_ = target;
+  }
+}
+
+void State::smoothPath(std::vector<PathPoint> path,
+                       const PathSmoother::SegmentCheck& is_free,
+                       double resolution, std::uint32_t seed) {
+  smoothing_stats_ = path_smoother_.smooth(
+      path, is_free, resolution, smoothing_budget_ms_, smooth_spline_, seed);
+  smoothed_path_ = std::move(path);
+}
+
+void State::updateReplay(const float& dt) {
+  if (replay_paused_) return;
+
+  const std::size_t recorded = trace_.size();
+  replay_budget_ += static_cast<double>(replay_speed_) * dt;
+  const auto steps = static_cast<std::size_t>(replay_budget_);
+  replay_budget_ -= static_cast<double>(steps);
+
+  // don't let the budget pile up while waiting for the solver
+  if (replay_cursor_ + steps >= recorded) replay_budget_ = 0.0;
+
+  seekReplay(replay_cursor_ + steps);
+}
+
+void State::renderReplayGui() {
+  ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(8.f, 8.f));
+  if (ImGui::CollapsingHeader("Replay", ImGuiTreeNodeFlags_DefaultOpen)) {
+    ImGui::Indent(8.f);
+    ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 6.f);
+    ImGui::PushStyleVar(ImGuiStyleVar_ItemInnerSpacing, ImVec2(2.f, 4.f));
+
+    if (ImGui::Button(replay_paused_ ? "Play" : "Pause")) {
+      replay_paused_ = !replay_paused_;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Restart")) {
+      seekReplay(0u);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Jump to End")) {
+      seekReplay(trace_.size());
+    }
+
+    ImGui::SliderFloat("speed", &replay_speed_, 10.f, 1e7f, "%.0f events/s",
+                       ImGuiSliderFlags_Logarithmic);
+    ImGui::SameLine();
+    gui::HelpMarker(
+        "Planners run at full speed and record their events.\nThe planning "
+        "scene animates the recorded events at this speed.");
+
+    // scrub backward and forward through the recorded events
+    const ImU64 recorded = static_cast<ImU64>(trace_.size());
+    ImU64 cursor = static_cast<ImU64>(replay_cursor_);
+    const ImU64 first = 0u;
+    if (ImGui::SliderScalar("event", ImGuiDataType_U64, &cursor, &first,
+                            &recorded, "%llu")) {
+      seekReplay(static_cast<std::size_t>(cursor));
+    }
+
+    ImGui::InputText("##trace_filename", trace_filename_,
+                     sizeof(trace_filename_));
+    ImGui::SameLine();
+    if (ImGui::Button("Save Trace")) {
+      if (trace_.save(trace_filename_)) {
+        logger_panel_->info("Saved " + std::to_string(trace_.size()) +
+                            " trace events to " + trace_filename_);
+      } else {
+        logger_panel_->info("Failed to save trace to " +
+                            std::string(trace_filename_));
+      }
+    }
+    if (supportsReplayExport()) {
+      ImGui::SameLine();
+      if (ImGui::Button("Export Replay")) {
+        // the replayed state never depends on how far the solver is
+        const std::string filename = std::string(trace_filename_) + ".csv";
+        if (exportReplay(filename)) {
+          logger_panel_->info("Saved the state after " +
+                              std::to_string(replay_cursor_) + " events to " +
+                              filename);
+        } else {
+          logger_panel_->info("Failed to save the replayed state to " +
+                              filename);
+        }
+      }
+    }
+
+    ImGui::PopStyleVar(2);
+    ImGui::Unindent(8.f);
+    ImGui::Spacing();
+  }
+  ImGui::PopStyleVar();
+}
+
+void State::renderSmoothingGui() {
+  gui::checkbox("smooth path", &smooth_path_,
+                "Shortcut the solution path once planning is done");
+  if (!smooth_path_) ImGui::BeginDisabled();
+  gui::checkbox("B-spline", &smooth_spline_,
+                "Fit a B-spline through the shortcut path");
+  gui::inputDouble("smoothing budget", &smoothing_budget_ms_, 1.0, 10000.0,
+                   10.0, 100.0, "Time limit of the post-processing in ms",
+                   "%.0f ms");
+  if (!smooth_path_) ImGui::EndDisabled();
+}
+
+void State::renderSmoothingStats() {
+  if (smoothed_path_.empty()) return;
+  const SmoothingStats& s = smoothing_stats_;
+  const double reduction =
+      s.initial_cost > 0.0 ? 100.0 * (1.0 - s.final_cost / s.initial_cost)
+                           : 0.0;
+  ImGui::Text("Path cost: %.4f -> %.4f (%.1f%% shorter)", s.initial_cost,
+              s.final_cost, reduction);
+  ImGui::Text("Shortcuts: %zu (cost %.4f)", s.no_of_shortcuts,
+              s.shortcut_cost);
+  ImGui::Text("Smoothing: %.2f ms, %zu collision checks%s", s.time_ms,
+              s.no_of_collision_checks,
+              s.budget_exceeded ? " (budget spent)" : "");
+}
+
+void State::logSmoothing() {
+  if (smoothed_path_.empty()) return;
+  char buf[128];
+  std::snprintf(buf, sizeof(buf),
+                "Path smoothed from %.4f to %.4f in %.2f ms%s",
+                smoothing_stats_.initial_cost, smoothing_stats_.final_cost,
+                smoothing_stats_.time_ms,
+                smoothing_stats_.budget_exceeded ? " (budget spent)" : "");
+  logger_panel_->info(buf);
+}
+
+void State::renderStats() {
+  const std::size_t events = trace_.size();
+  const std::size_t expansions = trace_.count(TraceEventType::EXPAND) +
+                                 trace_.count(TraceEventType::ADD_VERTEX);
+  const double mb = 1024.0 * 1024.0;
+
+  ImGui::Text("Trace events: %zu (%zu replayed)", events, replay_cursor_);
+  ImGui::Text("Trace memory: %.2f MB (%zu bytes/event)", trace_.bytes() / mb,
+              sizeof(TraceEvent));
+  if (expansions > 0u) {
+    ImGui::Text("Trace size: %.2f MB per 1M expansions",
+                static_cast<double>(events * sizeof(TraceEvent)) /
+                    static_cast<double>(expansions) * 1e6 / mb);
+  }
+}
+
+}  // namespace path_finding_visualizer
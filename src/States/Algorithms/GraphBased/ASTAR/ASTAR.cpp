@@ -4,8 +4,9 @@ namespace path_finding_visualizer {
 namespace graph_based {
 
 // Constructor
-ASTAR::ASTAR(std::shared_ptr<gui::LoggerPanel> logger_panel)
-    : BFS(logger_panel) {}
+ASTAR::ASTAR(std::shared_ptr<gui::LoggerPanel> logger_panel,
+             std::shared_ptr<ThreadPool> thread_pool)
+    : BFS(logger_panel, thread_pool) {}
 
 // Destructor
 ASTAR::~ASTAR() {}
@@ -19,43 +20,57 @@ void ASTAR::initAlgorithm() {
 
   use_manhattan_heuristics_ = (grid_connectivity_ == 0) ? true : false;
 
-  nodeStart_->setGDistance(0.0);
-  nodeStart_->setFDistance(utils::costToGoHeuristics(
-      *nodeStart_, *nodeEnd_, use_manhattan_heuristics_));
-  frontier_.push(nodeStart_);
+  const sf::Vector2i start_pos = cellPos(start_cell_);
+  const float start_f = static_cast<float>(utils::costToGoHeuristics(
+      start_pos, cellPos(goal_cell_), use_manhattan_heuristics_));
+  SearchCell &start = search_.at(start_pos.x, start_pos.y);
+  start.g = 0.f;
+  start.f = start_f;
+  frontier_.push(PriorityCell(start_f, start_cell_));
 }
 
-void ASTAR::updatePlanner(bool &solved, Node &start_node, Node &end_node) {
+void ASTAR::updatePlanner(bool &solved, CellIndex start_cell,
+                          CellIndex goal_cell) {
   if (!frontier_.empty()) {
-    std::shared_ptr<Node> node_current = frontier_.top();
-    node_current->setFrontier(false);
-    node_current->setVisited(true);
+    const CellIndex cell_current = frontier_.top().second;
     frontier_.pop();
 
-    if (node_current->isGoal()) {
+    const sf::Vector2i current_pos = cellPos(cell_current);
+    SearchCell &current = search_.at(current_pos.x, current_pos.y);
+    // skip stale entries of cells that were already expanded
+    if (current.visited) return;
+    current.visited = true;
+    recordExpand(cell_current);
+
+    if (cell_current == goal_cell) {
       solved = true;
     }
 
-    for (auto node_neighbour : *node_current->getNeighbours()) {
-      if (node_neighbour->isVisited() || node_neighbour->isObstacle()) {
-        continue;
-      }
+    const sf::Vector2i goal_pos = cellPos(goal_cell);
+    sf::Vector2i neighbours[8];
+    const int n = findNeighbours(current_pos, neighbours);
+    for (int i = 0; i < n; i++) {
+      const sf::Vector2i &pos = neighbours[i];
+      if (isObstacle(pos)) continue;
+
+      SearchCell &cell_neighbour = search_.at(pos.x, pos.y);
+      if (cell_neighbour.visited) continue;
 
-      double dist = node_current->getGDistance() +
-                    utils::costToGoHeuristics(*node_current, *node_neighbour,
-                                              use_manhattan_heuristics_);
+      const float dist =
+          current.g + static_cast<float>(utils::costToGoHeuristics(
+                          current_pos, pos, use_manhattan_heuristics_));
 
-      if (dist < node_neighbour->getGDistance()) {
-        node_neighbour->setParentNode(node_current);
-        node_neighbour->setGDistance(dist);
+      if (dist < cell_neighbour.g) {
+        const CellIndex neighbour = cellIndex(pos);
+        cell_neighbour.parent = cell_current;
+        cell_neighbour.g = dist;
 
         // f = g + h
-        double f_dist = node_current->getGDistance() +
-                        utils::costToGoHeuristics(*node_neighbour, end_node,
-                                                  use_manhattan_heuristics_);
-        node_neighbour->setFDistance(f_dist);
-        node_neighbour->setFrontier(true);
-        frontier_.push(node_neighbour);
+        cell_neighbour.f =
+            dist + static_cast<float>(utils::costToGoHeuristics(
+                       pos, goal_pos, use_manhattan_heuristics_));
+        frontier_.push(PriorityCell(cell_neighbour.f, neighbour));
+        recordFrontier(neighbour, cell_current);
       }
     }
   } else {
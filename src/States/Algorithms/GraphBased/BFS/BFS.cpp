@@ -1,11 +1,15 @@
 #include "States/Algorithms/GraphBased/BFS/BFS.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace path_finding_visualizer {
 namespace graph_based {
 
 // Constructor
-BFS::BFS(std::shared_ptr<gui::LoggerPanel> logger_panel)
-    : GraphBased(logger_panel) {}
+BFS::BFS(std::shared_ptr<gui::LoggerPanel> logger_panel,
+         std::shared_ptr<ThreadPool> thread_pool)
+    : GraphBased(logger_panel, thread_pool) {}
 
 // Destructor
 BFS::~BFS() {}
@@ -17,7 +21,9 @@ void BFS::initAlgorithm() {
     frontier_.pop();
   }
 
-  frontier_.push(nodeStart_);
+  const sf::Vector2i start_pos = cellPos(start_cell_);
+  search_.at(start_pos.x, start_pos.y).visited = true;
+  frontier_.push(start_cell_);
 }
 
 // override updateNodes() function
@@ -26,45 +32,38 @@ void BFS::updateNodes() {
     int localY = ((mousePositionWindow_.x - init_grid_xy_.x) / grid_size_);
     int localX = ((mousePositionWindow_.y - init_grid_xy_.y) / grid_size_);
 
-    if (localX >= 0 && localX < map_height_ / grid_size_) {
-      if (localY >= 0 && localY < map_width_ / grid_size_) {
-        // get the selected node
-        std::shared_ptr<Node> selectedNode =
-            nodes_[(map_width_ / grid_size_) * localX + localY];
+    if (localX >= 0 && localX < no_of_grid_rows_) {
+      if (localY >= 0 && localY < no_of_grid_cols_) {
+        // get the selected cell
+        const sf::Vector2i selected_pos(localX, localY);
+        const CellIndex selected_cell = cellIndex(selected_pos);
 
         // check the position is Obstacle free or not
-        bool isObstacle = false;
-        if (selectedNode->isObstacle()) {
-          isObstacle = true;
-        }
+        const bool is_obstacle = isObstacle(selected_pos);
+        markSceneChanged();
 
         if (!is_solved_) {
           if (sf::Keyboard::isKeyPressed(sf::Keyboard::LShift)) {
-            if (!isObstacle) {
-              if (selectedNode != nodeEnd_) {
-                nodeStart_->setStart(false);
-                nodeStart_ = selectedNode;
-                nodeStart_->setStart(true);
+            if (!is_obstacle) {
+              if (selected_cell != goal_cell_) {
+                start_cell_ = selected_cell;
               }
             }
           } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl)) {
-            if (!isObstacle) {
-              if (selectedNode != nodeStart_) {
-                nodeEnd_->setGoal(false);
-                nodeEnd_ = selectedNode;
-                nodeEnd_->setGoal(true);
+            if (!is_obstacle) {
+              if (selected_cell != start_cell_) {
+                goal_cell_ = selected_cell;
               }
             }
           } else {
-            selectedNode->setObstacle(!isObstacle);
+            obstacles_.at(localX, localY) = !is_obstacle;
+            lod_.markDirty(localX, localY);
           }
         } else {
           if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl)) {
-            if (!isObstacle) {
-              if (selectedNode != nodeStart_) {
-                nodeEnd_->setGoal(false);
-                nodeEnd_ = selectedNode;
-                nodeEnd_->setGoal(true);
+            if (!is_obstacle) {
+              if (selected_cell != start_cell_) {
+                goal_cell_ = selected_cell;
               }
             }
           }
@@ -81,67 +80,164 @@ void BFS::renderNodes(sf::RenderTexture &render_texture) {
   init_grid_xy_.x = (texture_size.x / 2.) - (map_width_ / 2.);
   init_grid_xy_.y = (texture_size.y / 2.) - (map_height_ / 2.);
 
-  for (int x = 0; x < map_height_ / grid_size_; x++) {
-    for (int y = 0; y < map_width_ / grid_size_; y++) {
-      float size = static_cast<float>(grid_size_);
-      sf::RectangleShape rectangle(sf::Vector2f(size, size));
-      rectangle.setOutlineThickness(2.f);
-      rectangle.setOutlineColor(BGN_COL);
-      rectangle.setPosition(init_grid_xy_.x + y * size,
-                            init_grid_xy_.y + x * size);
-
-      int nodeIndex = (map_width_ / grid_size_) * x + y;
-
-      if (nodes_[nodeIndex]->isObstacle()) {
-        rectangle.setFillColor(OBST_COL);
-      } else if (nodes_[nodeIndex]->isPath()) {
-        rectangle.setFillColor(PATH_COL);
-        nodes_[nodeIndex]->setPath(false);
-      } else if (nodes_[nodeIndex]->isFrontier()) {
-        rectangle.setFillColor(FRONTIER_COL);
-      } else if (nodes_[nodeIndex]->isVisited()) {
-        rectangle.setFillColor(VISITED_COL);
-      } else {
-        rectangle.setFillColor(IDLE_COL);
+  // only the cells inside the view rectangle are drawn
+  const float size = static_cast<float>(grid_size_);
+  const sf::View &view = render_texture.getView();
+  const sf::Vector2f view_min = view.getCenter() - view.getSize() / 2.f;
+  const sf::Vector2f view_max = view_min + view.getSize();
+  const int row_begin = std::max(
+      0, static_cast<int>(std::floor((view_min.y - init_grid_xy_.y) / size)));
+  const int row_end = std::min(
+      no_of_grid_rows_,
+      static_cast<int>(std::ceil((view_max.y - init_grid_xy_.y) / size)));
+  const int col_begin = std::max(
+      0, static_cast<int>(std::floor((view_min.x - init_grid_xy_.x) / size)));
+  const int col_end = std::min(
+      no_of_grid_cols_,
+      static_cast<int>(std::ceil((view_max.x - init_grid_xy_.x) / size)));
+  if (row_begin >= row_end || col_begin >= col_end) return;
+
+  // screen pixels per scene unit
+  const float pixel_scale = texture_size.x / view.getSize().x;
+  const float cell_pixels = size * pixel_scale;
+
+  scene_vertices_.setPrimitiveType(sf::Quads);
+  scene_vertices_.clear();
+  auto append_quad = [this](float left, float top, float right, float bottom,
+                            const sf::Color &color) {
+    scene_vertices_.append(sf::Vertex(sf::Vector2f(left, top), color));
+    scene_vertices_.append(sf::Vertex(sf::Vector2f(right, top), color));
+    scene_vertices_.append(sf::Vertex(sf::Vector2f(right, bottom), color));
+    scene_vertices_.append(sf::Vertex(sf::Vector2f(left, bottom), color));
+  };
+
+  // grid lines are only drawn while they stay a few pixels apart
+  const bool draw_grid_lines = cell_pixels >= 4.f;
+  const float inset = draw_grid_lines ? 1.f : 0.f;
+  append_quad(init_grid_xy_.x + col_begin * size - inset,
+              init_grid_xy_.y + row_begin * size - inset,
+              init_grid_xy_.x + col_end * size + inset,
+              init_grid_xy_.y + row_end * size + inset,
+              draw_grid_lines ? BGN_COL : IDLE_COL);
+
+  if (cell_pixels >= 1.f) {
+    for (int x = row_begin; x < row_end; x++) {
+      for (int y = col_begin; y < col_end; y++) {
+        // search state comes from the replayed trace
+        const std::uint8_t code = displayCode(x, y);
+        if (code == DISPLAY_IDLE && !draw_grid_lines) continue;
+
+        append_quad(init_grid_xy_.x + y * size + inset,
+                    init_grid_xy_.y + x * size + inset,
+                    init_grid_xy_.x + (y + 1) * size - inset,
+                    init_grid_xy_.y + (x + 1) * size - inset,
+                    displayColor(code));
       }
-
-      if (nodes_[nodeIndex]->isStart()) {
-        rectangle.setFillColor(START_COL);
-      } else if (nodes_[nodeIndex]->isGoal()) {
-        rectangle.setFillColor(END_COL);
+    }
+  } else {
+    // cells are smaller than a pixel, draw blocks of the downsampled gridmap
+    int level = 1;
+    while (level < lod_.maxLevel() &&
+           cell_pixels * static_cast<float>(1 << level) < 1.f) {
+      level++;
+    }
+    lod_.refresh([this](int row, int col) { return displayCode(row, col); });
+
+    for (int bx = row_begin >> level; bx <= (row_end - 1) >> level; bx++) {
+      for (int by = col_begin >> level; by <= (col_end - 1) >> level; by++) {
+        const std::uint8_t code = lod_.block(level, bx, by);
+        if (code == DISPLAY_IDLE) continue;
+
+        append_quad(
+            init_grid_xy_.x + (by << level) * size,
+            init_grid_xy_.y + (bx << level) * size,
+            init_grid_xy_.x +
+                std::min((by + 1) << level, no_of_grid_cols_) * size,
+            init_grid_xy_.y +
+                std::min((bx + 1) << level, no_of_grid_rows_) * size,
+            displayColor(code));
       }
-      render_texture.draw(rectangle);
     }
   }
 
+  // path, start & goal are drawn on top, at least a few pixels wide
+  const float min_size = 3.f / pixel_scale;
+  auto append_cell = [&](CellIndex cell, const sf::Color &color) {
+    const sf::Vector2i pos = cellPos(cell);
+    if (pos.x < row_begin || pos.x >= row_end || pos.y < col_begin ||
+        pos.y >= col_end) {
+      return;
+    }
+    const float pad = std::max((min_size - size) / 2.f, -inset);
+    append_quad(init_grid_xy_.x + pos.y * size - pad,
+                init_grid_xy_.y + pos.x * size - pad,
+                init_grid_xy_.x + (pos.y + 1) * size + pad,
+                init_grid_xy_.y + (pos.x + 1) * size + pad, color);
+  };
+
   // visualizing path
-  if (nodeEnd_ != nullptr) {
-    std::shared_ptr<Node> current = nodeEnd_;
-    while (current->getParentNode() != nullptr && !current->isStart()) {
-      current->setPath(true);
-      current = current->getParentNode();
+  const sf::Vector2i goal_pos = cellPos(goal_cell_);
+  CellIndex current = replay_.get(goal_pos.x, goal_pos.y).parent;
+  while (current != Trace::NO_PARENT && current != start_cell_) {
+    append_cell(current, PATH_COL);
+    const sf::Vector2i pos = cellPos(current);
+    current = replay_.get(pos.x, pos.y).parent;
+  }
+
+  // smoothed path once the replay has caught up with the solver, as quads
+  // along its segments
+  if (is_solved_ && replay_cursor_ == trace_.size()) {
+    const float half_width = std::max(min_size, size / 4.f) / 2.f;
+    for (std::size_t i = 1u; i < smoothed_path_.size(); ++i) {
+      const PathPoint &a = smoothed_path_[i - 1u], &b = smoothed_path_[i];
+      const sf::Vector2f p1(init_grid_xy_.x + a.y * size,
+                            init_grid_xy_.y + a.x * size);
+      const sf::Vector2f p2(init_grid_xy_.x + b.y * size,
+                            init_grid_xy_.y + b.x * size);
+      const sf::Vector2f d = p2 - p1;
+      const float len = std::sqrt(d.x * d.x + d.y * d.y);
+      if (len <= 0.f) continue;
+      const sf::Vector2f offset(-d.y / len * half_width,
+                                d.x / len * half_width);
+      scene_vertices_.append(sf::Vertex(p1 + offset, SMOOTH_PATH_COL));
+      scene_vertices_.append(sf::Vertex(p2 + offset, SMOOTH_PATH_COL));
+      scene_vertices_.append(sf::Vertex(p2 - offset, SMOOTH_PATH_COL));
+      scene_vertices_.append(sf::Vertex(p1 - offset, SMOOTH_PATH_COL));
     }
   }
+
+  append_cell(start_cell_, START_COL);
+  append_cell(goal_cell_, END_COL);
+
+  render_texture.draw(scene_vertices_);
 }
 
 void BFS::renderParametersGui() {}
 
-void BFS::updatePlanner(bool &solved, Node &start_node, Node &end_node) {
+void BFS::updatePlanner(bool &solved, CellIndex start_cell,
+                        CellIndex goal_cell) {
   if (!frontier_.empty()) {
-    std::shared_ptr<Node> node_current = frontier_.front();
-    node_current->setFrontier(false);
+    const CellIndex cell_current = frontier_.front();
     frontier_.pop();
+    recordExpand(cell_current);
 
-    if (node_current->isGoal()) {
+    if (cell_current == goal_cell) {
       solved = true;
     }
 
-    for (auto node_neighbour : *node_current->getNeighbours()) {
-      if (!node_neighbour->isVisited() && node_neighbour->isObstacle() == 0) {
-        node_neighbour->setParentNode(node_current);
-        node_neighbour->setVisited(true);
-        node_neighbour->setFrontier(true);
-        frontier_.push(node_neighbour);
+    sf::Vector2i neighbours[8];
+    const int n = findNeighbours(cellPos(cell_current), neighbours);
+    for (int i = 0; i < n; i++) {
+      const sf::Vector2i &pos = neighbours[i];
+      if (isObstacle(pos)) continue;
+
+      SearchCell &cell_neighbour = search_.at(pos.x, pos.y);
+      if (!cell_neighbour.visited) {
+        const CellIndex neighbour = cellIndex(pos);
+        cell_neighbour.parent = cell_current;
+        cell_neighbour.visited = true;
+        frontier_.push(neighbour);
+        recordFrontier(neighbour, cell_current);
       }
     }
   } else {
@@ -4,7 +4,9 @@ namespace path_finding_visualizer {
 namespace graph_based {
 
 // Constructor
-DFS::DFS(std::shared_ptr<gui::LoggerPanel> logger_panel) : BFS(logger_panel) {}
+DFS::DFS(std::shared_ptr<gui::LoggerPanel> logger_panel,
+         std::shared_ptr<ThreadPool> thread_pool)
+    : BFS(logger_panel, thread_pool) {}
 
 // Destructor
 DFS::~DFS() {}
@@ -16,25 +18,35 @@ void DFS::initAlgorithm() {
     frontier_.pop();
   }
 
-  frontier_.push(nodeStart_);
+  const sf::Vector2i start_pos = cellPos(start_cell_);
+  search_.at(start_pos.x, start_pos.y).visited = true;
+  frontier_.push(start_cell_);
 }
 
-void DFS::updatePlanner(bool &solved, Node &start_node, Node &end_node) {
+void DFS::updatePlanner(bool &solved, CellIndex start_cell,
+                        CellIndex goal_cell) {
   if (!frontier_.empty()) {
-    std::shared_ptr<Node> node_current = frontier_.top();
-    node_current->setFrontier(false);
+    const CellIndex cell_current = frontier_.top();
     frontier_.pop();
+    recordExpand(cell_current);
 
-    if (node_current->isGoal()) {
+    if (cell_current == goal_cell) {
       solved = true;
     }
 
-    for (auto node_neighbour : *node_current->getNeighbours()) {
-      if (!node_neighbour->isVisited() && node_neighbour->isObstacle() == 0) {
-        node_neighbour->setParentNode(node_current);
-        node_neighbour->setVisited(true);
-        node_neighbour->setFrontier(true);
-        frontier_.push(node_neighbour);
+    sf::Vector2i neighbours[8];
+    const int n = findNeighbours(cellPos(cell_current), neighbours);
+    for (int i = 0; i < n; i++) {
+      const sf::Vector2i &pos = neighbours[i];
+      if (isObstacle(pos)) continue;
+
+      SearchCell &cell_neighbour = search_.at(pos.x, pos.y);
+      if (!cell_neighbour.visited) {
+        const CellIndex neighbour = cellIndex(pos);
+        cell_neighbour.parent = cell_current;
+        cell_neighbour.visited = true;
+        frontier_.push(neighbour);
+        recordFrontier(neighbour, cell_current);
       }
     }
   } else {
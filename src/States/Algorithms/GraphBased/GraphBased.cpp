@@ -1,20 +1,33 @@
 #include "GraphBased.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
 namespace path_finding_visualizer {
 namespace graph_based {
 
 // Constructor
-GraphBased::GraphBased(std::shared_ptr<gui::LoggerPanel> logger_panel)
-    : State(logger_panel), keyTimeMax_{1.f}, keyTime_{0.f} {
+GraphBased::GraphBased(std::shared_ptr<gui::LoggerPanel> logger_panel,
+                       std::shared_ptr<ThreadPool> thread_pool)
+    : State(logger_panel, thread_pool),
+      keyTimeMax_{1.f},
+      keyTime_{0.f},
+      search_{SearchCell()},
+      replay_{ReplayCell()} {
   initVariables();
-  initNodes();
+  initGrid();
   initColors();
 }
 
 // Destructor
 GraphBased::~GraphBased() {
-  if (!thread_joined_) {
-    t_.join();
+  if (solver_.valid()) {
+    std::unique_lock<std::mutex> lck(mutex_);
+    is_stopped_ = true;
+    lck.unlock();
+    solver_.wait();
   }
 }
 
@@ -28,7 +41,7 @@ void GraphBased::initVariables() {
   is_initialized_ = false;
   is_reset_ = false;
   is_solved_ = false;
-  thread_joined_ = true;
+  is_stopped_ = false;
   disable_run_ = false;
   disable_gui_parameters_ = false;
 }
@@ -53,65 +66,128 @@ void GraphBased::initColors() {
   FRONTIER_COL = sf::Color(242, 204, 209, 255);
   OBST_COL = sf::Color(186, 186, 186, 255);
   PATH_COL = sf::Color(190, 242, 227, 255);
+  SMOOTH_PATH_COL = sf::Color(78, 95, 131, 255);
 }
 
-void GraphBased::initNodes(bool reset, bool reset_neighbours_only) {
+void GraphBased::initGrid(bool reset) {
   map_width_ = no_of_grid_cols_ * grid_size_;
   map_height_ = no_of_grid_rows_ * grid_size_;
 
   if (reset) {
-    nodes_.clear();
-
-    for (int i = 0; i < (map_width_ / grid_size_) * (map_height_ / grid_size_);
-         i++) {
-      nodes_.emplace_back(std::make_shared<Node>());
-    }
+    // new gridmap without obstacles
+    obstacles_.resize(no_of_grid_rows_, no_of_grid_cols_);
+    search_.resize(no_of_grid_rows_, no_of_grid_cols_);
+    replay_.resize(no_of_grid_rows_, no_of_grid_cols_);
+    lod_.resize(no_of_grid_rows_, no_of_grid_cols_);
+
+    // initialize start and goal cells (upper left and lower right corners)
+    start_cell_ = cellIndex(sf::Vector2i(0, 0));
+    goal_cell_ =
+        cellIndex(sf::Vector2i(no_of_grid_rows_ - 1, no_of_grid_cols_ - 1));
   }
 
-  // set all nodes to free obsts and respective positions
-  for (int x = 0; x < map_height_ / grid_size_; x++) {
-    for (int y = 0; y < map_width_ / grid_size_; y++) {
-      int nodeIndex = (map_width_ / grid_size_) * x + y;
-      if (reset) {
-        nodes_[nodeIndex]->setPosition(sf::Vector2i(x, y));
-        nodes_[nodeIndex]->setObstacle(false);
-        nodes_[nodeIndex]->setStart(false);
-        nodes_[nodeIndex]->setGoal(false);
+  // drop the search state, only the touched tiles need to be released
+  search_.reset();
+
+  // any change to the gridmap invalidates the recorded trace
+  resetTrace();
+}
+
+CellIndex GraphBased::cellIndex(const sf::Vector2i& pos) const {
+  return static_cast<CellIndex>(pos.x) *
+             static_cast<CellIndex>(no_of_grid_cols_) +
+         static_cast<CellIndex>(pos.y);
+}
+
+sf::Vector2i GraphBased::cellPos(CellIndex idx) const {
+  const CellIndex cols = static_cast<CellIndex>(no_of_grid_cols_);
+  return sf::Vector2i(static_cast<int>(idx / cols),
+                      static_cast<int>(idx % cols));
+}
+
+bool GraphBased::isObstacle(const sf::Vector2i& pos) const {
+  return obstacles_.get(pos.x, pos.y) != 0u;
+}
+
+bool GraphBased::isSegmentFree(const PathPoint& a, const PathPoint& b) const {
+  // cells outside the gridmap count as obstacles
+  auto blocked = [this](int row, int col) {
+    return row < 0 || col < 0 || row >= no_of_grid_rows_ ||
+           col >= no_of_grid_cols_ || obstacles_.get(row, col) != 0u;
+  };
+
+  // walk the cells crossed by the segment
+  int row = static_cast<int>(std::floor(a.x));
+  int col = static_cast<int>(std::floor(a.y));
+  const int end_row = static_cast<int>(std::floor(b.x));
+  const int end_col = static_cast<int>(std::floor(b.y));
+  const double dx = b.x - a.x, dy = b.y - a.y;
+  const int step_row = dx > 0.0 ? 1 : -1;
+  const int step_col = dy > 0.0 ? 1 : -1;
+  const double inf = std::numeric_limits<double>::infinity();
+  // segment parameter per cell & up to the first cell border
+  const double delta_row = dx != 0.0 ? std::fabs(1.0 / dx) : inf;
+  const double delta_col = dy != 0.0 ? std::fabs(1.0 / dy) : inf;
+  double t_row =
+      dx != 0.0 ? (dx > 0.0 ? row + 1 - a.x : a.x - row) * delta_row : inf;
+  double t_col =
+      dy != 0.0 ? (dy > 0.0 ? col + 1 - a.y : a.y - col) * delta_col : inf;
+
+  if (blocked(row, col)) return false;
+  int steps = std::abs(end_row - row) + std::abs(end_col - col);
+  while (steps > 0) {
+    if (t_row < t_col) {
+      row += step_row;
+      t_row += delta_row;
+    } else if (t_col < t_row) {
+      col += step_col;
+      t_col += delta_col;
+    } else {
+      // through a corner, both cells beside it must be free as well
+      if (blocked(row + step_row, col) || blocked(row, col + step_col)) {
+        return false;
       }
-      nodes_[nodeIndex]->setVisited(false);
-      nodes_[nodeIndex]->setFrontier(false);
-      nodes_[nodeIndex]->setPath(false);
-      nodes_[nodeIndex]->setParentNode(nullptr);
-      nodes_[nodeIndex]->setGDistance(INFINITY);
-      nodes_[nodeIndex]->setFDistance(INFINITY);
+      row += step_row;
+      col += step_col;
+      t_row += delta_row;
+      t_col += delta_col;
+      --steps;
     }
+    --steps;
+    if (blocked(row, col)) return false;
   }
+  return true;
+}
 
+int GraphBased::findNeighbours(const sf::Vector2i& pos,
+                               sf::Vector2i* neighbours) const {
   // add neighbours based on 4 or 8 connectivity grid
-  if (reset || reset_neighbours_only) {
-    for (int x = 0; x < map_height_ / grid_size_; x++) {
-      for (int y = 0; y < map_width_ / grid_size_; y++) {
-        int nodeIndex = (map_width_ / grid_size_) * x + y;
-        nodes_[nodeIndex]->clearNeighbours();
-        utils::addNeighbours(nodes_, nodeIndex,
-                             static_cast<unsigned>(map_width_ / grid_size_),
-                             static_cast<unsigned>(map_height_ / grid_size_),
-                             [](int connectivity) {
-                               return (connectivity == 1) ? true : false;
-                             }(grid_connectivity_));
-      }
-    }
+  return utils::findNeighbours(pos, no_of_grid_rows_, no_of_grid_cols_,
+                               neighbours, grid_connectivity_ == 1);
+}
+
+std::uint8_t GraphBased::displayCode(int row, int col) const {
+  if (obstacles_.get(row, col)) return DISPLAY_OBSTACLE;
+  switch (replay_.get(row, col).state) {
+    case CELL_FRONTIER:
+      return DISPLAY_FRONTIER;
+    case CELL_VISITED:
+      return DISPLAY_VISITED;
+    default:
+      return DISPLAY_IDLE;
   }
+}
 
-  if (reset) {
-    // initialize Start and End nodes ptrs (upper left and lower right corners)
-    nodeStart_ = nodes_[(map_width_ / grid_size_) * 0 + 0];
-    nodeStart_->setParentNode(nullptr);
-    nodeStart_->setStart(true);
-    nodeEnd_ =
-        nodes_[(map_width_ / grid_size_) * (map_height_ / grid_size_ - 1) +
-               (map_width_ / grid_size_ - 1)];
-    nodeEnd_->setGoal(true);
+const sf::Color& GraphBased::displayColor(std::uint8_t code) const {
+  switch (code) {
+    case DISPLAY_OBSTACLE:
+      return OBST_COL;
+    case DISPLAY_FRONTIER:
+      return FRONTIER_COL;
+    case DISPLAY_VISITED:
+      return VISITED_COL;
+    default:
+      return IDLE_COL;
   }
 }
 
@@ -149,7 +225,14 @@ void GraphBased::update(const float& dt, const ImVec2& mousePos) {
   updateMousePosition(mousePos);
 
   if (is_reset_) {
-    initNodes(false, false);
+    // stop the solver before touching the nodes
+    std::unique_lock<std::mutex> lck(mutex_);
+    is_stopped_ = true;
+    lck.unlock();
+
+    if (solver_.valid()) solver_.get();
+
+    initGrid(false);
     is_running_ = false;
     is_initialized_ = false;
     is_reset_ = false;
@@ -164,26 +247,34 @@ void GraphBased::update(const float& dt, const ImVec2& mousePos) {
 
     // initialize Algorithm
     if (!is_initialized_) {
+      resetTrace();
+      trace_.setDimensions(static_cast<std::uint32_t>(no_of_grid_cols_),
+                           static_cast<std::uint32_t>(no_of_grid_rows_));
       initAlgorithm();
 
-      // create thread
-      // solve the algorithm concurrently
-      t_ = std::thread(&GraphBased::solveConcurrently, this, nodeStart_,
-                       nodeEnd_, message_queue_);
+      std::unique_lock<std::mutex> lck(mutex_);
+      is_stopped_ = false;
+      lck.unlock();
+
+      // solve the algorithm concurrently on the thread pool
+      solver_ = thread_pool_->submit([this, start = start_cell_,
+                                      goal = goal_cell_,
+                                      queue = message_queue_]() {
+        solveConcurrently(start, goal, queue);
+      });
 
-      thread_joined_ = false;
       is_initialized_ = true;
       disable_gui_parameters_ = true;
     }
 
     // check the algorithm is solved or not
-    auto msg = message_queue_->receive();
+    bool msg = false;
     // if solved
-    if (msg) {
-      t_.join();
-      thread_joined_ = true;
+    if (message_queue_->tryReceive(msg) && msg) {
+      solver_.get();
       is_running_ = false;
       is_solved_ = true;
+      logSmoothing();
     }
   } else {
     // only allow mouse and key inputs
@@ -192,15 +283,15 @@ void GraphBased::update(const float& dt, const ImVec2& mousePos) {
     // virtual function updateNodes()
     updateNodes();
   }
+
+  // animate the recorded planner events
+  updateReplay(dt);
 }
 
 void GraphBased::clearObstacles() {
-  for (int x = 0; x < map_height_ / grid_size_; x++) {
-    for (int y = 0; y < map_width_ / grid_size_; y++) {
-      int nodeIndex = (map_width_ / grid_size_) * x + y;
-      nodes_[nodeIndex]->setObstacle(false);
-    }
-  }
+  obstacles_.reset();
+  lod_.markAllDirty();
+  markSceneChanged();
 }
 
 void GraphBased::renderGui() {
@@ -215,13 +306,13 @@ void GraphBased::renderGui() {
     ImGui::Text("Gridmap:");
     ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(8.f, 2.f));
 
-    if (gui::inputInt("rows", &no_of_grid_rows_, 5, 1000, 1, 10,
+    if (gui::inputInt("rows", &no_of_grid_rows_, 5, MAX_GRID_DIM, 1, 100,
                       "Number of rows in the gridmap"))
-      initNodes(true, false);
+      initGrid(true);
 
-    if (gui::inputInt("cols", &no_of_grid_cols_, 5, 1000, 1, 10,
+    if (gui::inputInt("cols", &no_of_grid_cols_, 5, MAX_GRID_DIM, 1, 100,
                       "Number of columns in the gridmap"))
-      initNodes(true, false);
+      initGrid(true);
 
     ImGui::PopStyleVar();
 
@@ -229,7 +320,7 @@ void GraphBased::renderGui() {
                       "The size of a grid. Set this size larger to zoom in the "
                       "gridmap.")) {
       grid_size_ = ui_grid_size_;
-      initNodes(true, false);
+      initGrid(true);
     }
 
     ImGui::Text("Random Obstacles:");
@@ -251,7 +342,7 @@ void GraphBased::renderGui() {
     ImGui::SameLine();
     if (ImGui::Button("Restore Defaults")) {
       initGridMapParams();
-      initNodes(true, false);
+      initGrid(true);
     }
 
     ImGui::PopStyleVar(2);
@@ -278,7 +369,7 @@ void GraphBased::renderGui() {
       ImGui::SameLine();
       b = ImGui::RadioButton("8-connected", &grid_connectivity_, 1);
       if (a || b) {
-        initNodes(false, true);
+        initGrid(false);
       }
       ImGui::SameLine();
       gui::HelpMarker(
@@ -292,6 +383,8 @@ void GraphBased::renderGui() {
     // need to be implemented by derived class
     renderParametersGui();
 
+    renderSmoothingGui();
+
     ImGui::PopStyleVar(3);
     ImGui::Unindent(8.f);
 
@@ -300,7 +393,10 @@ void GraphBased::renderGui() {
   ImGui::PopStyleVar();
 }
 
-void GraphBased::renderConfig() { renderGui(); }
+void GraphBased::renderConfig() {
+  renderGui();
+  renderReplayGui();
+}
 
 void GraphBased::renderScene(sf::RenderTexture& render_texture) {
   // virtual function renderNodes()
@@ -308,45 +404,98 @@ void GraphBased::renderScene(sf::RenderTexture& render_texture) {
   renderNodes(render_texture);
 }
 
+void GraphBased::resetReplay() {
+  replay_.reset();
+  lod_.markAllDirty();
+}
+
+void GraphBased::applyTraceEvent(const TraceEvent& e) {
+  const sf::Vector2i pos = cellPos(e.id);
+  lod_.markDirty(pos.x, pos.y);
+  switch (e.type) {
+    case TraceEventType::EXPAND:
+      replay_.at(pos.x, pos.y).state = CELL_VISITED;
+      break;
+    case TraceEventType::PUSH_FRONTIER: {
+      ReplayCell& cell = replay_.at(pos.x, pos.y);
+      cell.state = CELL_FRONTIER;
+      cell.parent = e.parent;
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void GraphBased::recordExpand(CellIndex cell) {
+  trace_.append({cell, Trace::NO_PARENT, 0u, 0u, TraceEventType::EXPAND});
+}
+
+void GraphBased::recordFrontier(CellIndex cell, CellIndex parent) {
+  trace_.append({cell, parent, 0u, 0u, TraceEventType::PUSH_FRONTIER});
+}
+
+void GraphBased::renderStats() {
+  const double mb = 1024.0 * 1024.0;
+  ImGui::Text("Gridmap: %d x %d cells", no_of_grid_rows_, no_of_grid_cols_);
+  ImGui::Text("Obstacle tiles: %zu (%.2f MB)", obstacles_.allocatedTiles(),
+              obstacles_.bytes() / mb);
+  ImGui::Text("Search tiles: %zu (%.2f MB)", search_.allocatedTiles(),
+              search_.bytes() / mb);
+  ImGui::Text("Replay tiles: %zu (%.2f MB)", replay_.allocatedTiles(),
+              replay_.bytes() / mb);
+  if (is_solved_) renderSmoothingStats();
+  State::renderStats();
+}
+
+void GraphBased::smoothSolution(CellIndex start_cell, CellIndex goal_cell) {
+  smoothed_path_.clear();
+  if (!smooth_path_) return;
+
+  // searched path from the goal back to the start, through cell centres
+  std::vector<PathPoint> path;
+  for (CellIndex cell = goal_cell;;) {
+    const sf::Vector2i pos = cellPos(cell);
+    path.push_back({pos.x + 0.5, pos.y + 0.5});
+    if (cell == start_cell) break;
+    cell = search_.get(pos.x, pos.y).parent;
+    if (cell == Trace::NO_PARENT) return;
+  }
+  std::reverse(path.begin(), path.end());
+
+  smoothPath(
+      std::move(path),
+      [this](const PathPoint& a, const PathPoint& b) {
+        return isSegmentFree(a, b);
+      },
+      0.25, 0u);
+}
+
 void GraphBased::solveConcurrently(
-    std::shared_ptr<Node> nodeStart, std::shared_ptr<Node> nodeEnd,
+    CellIndex start_cell, CellIndex goal_cell,
     std::shared_ptr<MessageQueue<bool>> message_queue) {
   // copy assignment
   // thread-safe due to shared_ptrs
-  std::shared_ptr<Node> s_nodeStart = nodeStart;
-  std::shared_ptr<Node> s_nodeEnd = nodeEnd;
   std::shared_ptr<MessageQueue<bool>> s_message_queue = message_queue;
 
   bool solved = false;
 
-  double cycleDuration = 1.0;  // duration of a single simulation cycle in ms
-  // init stop watch
-  auto lastUpdate = std::chrono::system_clock::now();
+  // run the planner at full speed, the UI replays the recorded trace
+  while (!solved) {
+    updatePlanner(solved, start_cell, goal_cell);
 
-  while (true) {
-    // compute time difference to stop watch
-    long timeSinceLastUpdate =
-        std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now() - lastUpdate)
-            .count();
-
-    if (timeSinceLastUpdate >= cycleDuration) {
-      updatePlanner(solved, *s_nodeStart, *s_nodeEnd);
-
-      // reset stop watch for next cycle
-      lastUpdate = std::chrono::system_clock::now();
-    }
-
-    // sends an update method to the message queue using move semantics
-    auto ftr = std::async(std::launch::async, &MessageQueue<bool>::send,
-                          s_message_queue, std::move(solved));
-    ftr.wait();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (is_stopped_) break;
+  }
 
-    if (solved) return;
+  // post-process the solution before the UI takes over
+  std::unique_lock<std::mutex> lck(mutex_);
+  const bool stopped = is_stopped_;
+  lck.unlock();
+  if (solved && !stopped) smoothSolution(start_cell, goal_cell);
 
-    // sleep at every iteration to reduce CPU usage
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-  }
+  // notify the UI that the planner has finished
+  s_message_queue->send(std::move(solved));
 }
 
 }  // namespace graph_based
@@ -0,0 +1,280 @@
+#include "States/Algorithms/SamplingBased/BIT_STAR/BIT_STAR.h"
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+// Constructor
+BIT_STAR::BIT_STAR(std::shared_ptr<gui::LoggerPanel> logger_panel,
+                   std::shared_ptr<ThreadPool> thread_pool,
+                   const std::string &name)
+    : INFORMED_RRT_STAR(logger_panel, thread_pool, name),
+      no_of_unconnected_{0u},
+      first_new_sample_{0u},
+      goal_sample_{NO_VERTEX},
+      goal_id_{NO_VERTEX},
+      radius_{0.0} {
+  initParameters();
+  initialize();
+}
+
+// Destructor
+BIT_STAR::~BIT_STAR() {}
+
+void BIT_STAR::initParameters() {
+  // initialize default planner related params
+  // TODO: default values should be read from file
+  max_iterations_ = 5000;
+  range_ = 0.05;
+  goal_radius_ = 0.1;
+  rewire_factor_ = 1.1;
+  update_goal_every_ = 100u;
+  prune_threshold_ = 0.0;
+  batch_size_ = 100;
+}
+
+// override initPlanner() function
+void BIT_STAR::initPlanner() {
+  INFORMED_RRT_STAR::initPlanner();
+  is_pruned_.assign(vertices_.size(), 0u);
+  is_old_.assign(vertices_.size(), 0u);
+
+  // the goal is a sample until an edge reaches it
+  samples_.clear();
+  sample_vertex_.clear();
+  sample_nn_ = makeNearestNeighbors(nn_backend_);
+  no_of_unconnected_ = 0u;
+  first_new_sample_ = 0u;
+  goal_sample_ = 0u;
+  goal_id_ = NO_VERTEX;
+  addSample(*goal_vertex_);
+
+  vertex_queue_ = decltype(vertex_queue_)();
+  edge_queue_ = decltype(edge_queue_)();
+  no_of_batches_ = 0u;
+}
+
+void BIT_STAR::renderParametersGui() {
+  gui::inputDouble("rewire_factor", &rewire_factor_, 1.0, 2.0, 0.01, 0.1,
+                   "Scales the connection radius", "%.2f");
+  gui::inputInt("batch_size", &batch_size_, 1, 100000, 10, 100,
+                "Number of samples added per batch");
+}
+
+void BIT_STAR::renderStats() {
+  ImGui::Text("Batches: %zu", no_of_batches_.load());
+  ImGui::Text("Pruned vertices: %zu", no_of_pruned_.load());
+  SamplingBased::renderStats();
+}
+
+void BIT_STAR::updatePlanner(bool &solved, Vertex &start, Vertex &goal) {
+  unsigned int iter_no;
+  if (!claimIteration(iter_no)) {
+    solved = true;
+    return;
+  }
+
+  // the batch is done once no queued edge can improve the solution
+  if (edge_queue_.empty() && vertex_queue_.empty()) newBatch();
+
+  // expand vertices while they could give better edges than the queued ones
+  while (!vertex_queue_.empty() &&
+         (edge_queue_.empty() ||
+          vertex_queue_.top().first <= edge_queue_.top().key)) {
+    const std::uint32_t id = vertex_queue_.top().second;
+    vertex_queue_.pop();
+    if (!is_pruned_[id]) expandVertex(id);
+  }
+  if (edge_queue_.empty()) return;
+
+  const QueueEdge e = edge_queue_.top();
+  edge_queue_.pop();
+  if (e.key >= best_cost_) {
+    // the remaining edges are no better, start over with a new batch
+    vertex_queue_ = decltype(vertex_queue_)();
+    edge_queue_ = decltype(edge_queue_)();
+    return;
+  }
+  processEdge(e, goal);
+}
+
+void BIT_STAR::addSample(const Vertex &v) {
+  const std::uint32_t s = static_cast<std::uint32_t>(samples_.size());
+  samples_.push_back(v);
+  sample_vertex_.push_back(NO_VERTEX);
+  sample_nn_->add(s, v.x, v.y);
+  ++no_of_unconnected_;
+}
+
+void BIT_STAR::newBatch() {
+  first_new_sample_ = static_cast<std::uint32_t>(samples_.size());
+  if (best_cost_ < pruned_cost_) {
+    pruneBatch();
+    pruned_cost_ = best_cost_;
+  }
+
+  // new samples from the informed set, invalid ones are dropped
+  for (int i = 0; i < batch_size_; ++i) {
+    Vertex v;
+    sample(v);
+    ++no_of_collision_checks_;
+    if (!isCollision(v, v)) addSample(v);
+  }
+
+  // every tree vertex is expanded again with the new samples
+  const std::uint32_t n = static_cast<std::uint32_t>(vertices_.size());
+  is_old_.assign(n, 1u);
+  for (std::uint32_t id = 0u; id < n; ++id) {
+    if (is_pruned_[id]) continue;
+    vertex_queue_.push({cost(id) + hHat(treeVertex(id)), id});
+  }
+  radius_ = connectionRadius();
+  ++no_of_batches_;
+}
+
+void BIT_STAR::pruneBatch() {
+  // keep only the unconnected samples that could improve the solution
+  std::vector<Vertex> kept;
+  kept.reserve(no_of_unconnected_);
+  for (std::size_t s = 0u; s < samples_.size(); ++s) {
+    if (sample_vertex_[s] != NO_VERTEX) continue;
+    if (gHat(samples_[s]) + hHat(samples_[s]) < best_cost_) {
+      kept.push_back(samples_[s]);
+    }
+  }
+
+  // cost-to-come plus the estimated cost-to-go never decreases along a tree
+  // edge, so the pruned vertices form whole subtrees. Pruned vertices that
+  // might still be on a better path are reused as new samples.
+  std::vector<Vertex> reused;
+  std::size_t pruned = 0u;
+  const std::uint32_t n = static_cast<std::uint32_t>(vertices_.size());
+  for (std::uint32_t id = 0u; id < n; ++id) {
+    if (is_pruned_[id]) continue;
+    const Vertex v = treeVertex(id);
+    if (cost(id) + hHat(v) <= best_cost_ + 1e-9) continue;
+    vertices_.detach(id);
+    is_pruned_[id] = 1u;
+    recordPrune(id);
+    ++pruned;
+    if (gHat(v) + hHat(v) < best_cost_) reused.push_back(v);
+  }
+  no_of_pruned_ += pruned;
+
+  // rebuild both indexes from what is left
+  nn_->clear();
+  for (std::uint32_t id = 0u; id < n; ++id) {
+    if (!is_pruned_[id]) nn_->add(id, vertices_.x[id], vertices_.y[id]);
+  }
+  samples_.clear();
+  sample_vertex_.clear();
+  sample_nn_->clear();
+  no_of_unconnected_ = 0u;
+  goal_sample_ = NO_VERTEX;
+  for (const Vertex &v : kept) addSample(v);
+  first_new_sample_ = static_cast<std::uint32_t>(samples_.size());
+  for (const Vertex &v : reused) addSample(v);
+}
+
+void BIT_STAR::expandVertex(std::uint32_t id) {
+  const Vertex v = treeVertex(id);
+  const double g = cost(id);
+  const double g_hat = gHat(v);
+  std::vector<std::uint32_t> &near_ids = worker().near_ids;
+
+  // edges to the unconnected samples, vertices of earlier batches have
+  // already seen the older ones
+  near_ids.clear();
+  sample_nn_->radius(v.x, v.y, radius_, near_ids);
+  for (const std::uint32_t s : near_ids) {
+    if (sample_vertex_[s] != NO_VERTEX) continue;
+    if (is_old_[id] && s < first_new_sample_) continue;
+    const Vertex &x = samples_[s];
+    const double c_hat = distance(v, x);
+    if (g_hat + c_hat + hHat(x) < best_cost_) {
+      edge_queue_.push({g + c_hat + hHat(x), id, s, false});
+    }
+  }
+
+  // rewires are only considered once, from the vertices new in this batch
+  if (is_old_[id]) return;
+  near_ids.clear();
+  nn_->radius(v.x, v.y, radius_, near_ids);
+  for (const std::uint32_t w : near_ids) {
+    if (w == id || vertices_.parent[id] == w || vertices_.parent[w] == id) {
+      continue;
+    }
+    const Vertex x = treeVertex(w);
+    const double c_hat = distance(v, x);
+    if (g_hat + c_hat + hHat(x) < best_cost_ && g + c_hat < cost(w)) {
+      edge_queue_.push({g + c_hat + hHat(x), id, w, true});
+    }
+  }
+}
+
+void BIT_STAR::processEdge(const QueueEdge &e, Vertex &goal) {
+  // the sample may have joined the tree since the edge was queued
+  const std::uint32_t to_id = e.to_vertex ? e.to : sample_vertex_[e.to];
+  const Vertex v = treeVertex(e.from);
+  const Vertex x = to_id == NO_VERTEX ? samples_[e.to] : treeVertex(to_id);
+  const double g = cost(e.from);
+  const double c_hat = distance(v, x);
+
+  // the edge must still improve both the solution and the target
+  if (g + c_hat + hHat(x) >= best_cost_) return;
+  if (to_id != NO_VERTEX && g + c_hat >= cost(to_id)) return;
+
+  // only now is the edge worth a collision check
+  ++no_of_collision_checks_;
+  if (isCollision(v, x)) return;
+
+  if (to_id == NO_VERTEX) {
+    const std::uint32_t new_id = vertices_.add(x.x, x.y, e.from, g + c_hat);
+    sample_vertex_[e.to] = new_id;
+    --no_of_unconnected_;
+    is_pruned_.resize(vertices_.size(), 0u);
+    is_old_.resize(vertices_.size(), 0u);
+    nn_->add(new_id, x.x, x.y);
+    recordVertex(new_id);
+    vertex_queue_.push({g + c_hat + hHat(x), new_id});
+    if (e.to == goal_sample_) {
+      goal_id_ = new_id;
+      goal_sample_ = NO_VERTEX;
+    }
+  } else {
+    // the whole subtree of x gets cheaper by the same amount
+    vertices_.reparent(to_id, e.from, g + c_hat);
+    recordRewire(to_id);
+  }
+
+  if (goal_id_ != NO_VERTEX && cost(goal_id_) < best_cost_) {
+    best_cost_ = cost(goal_id_);
+    if (goal.parent != goal_id_) {
+      recordSolution(goal_id_);
+      goal.parent = goal_id_;
+    }
+  }
+}
+
+double BIT_STAR::connectionRadius() const {
+  const double q = std::max(
+      static_cast<double>(nn_->size() + no_of_unconnected_), 2.0);
+
+  // measure of the informed set, the whole map until solved
+  double measure = 1.0;
+  if (best_cost_ < std::numeric_limits<double>::infinity()) {
+    const double c_min = distance(*start_vertex_, *goal_vertex_);
+    const double r1 = best_cost_ / 2.0;
+    const double r2 =
+        std::sqrt(std::max(best_cost_ * best_cost_ - c_min * c_min, 0.0)) / 2.0;
+    measure = std::min(measure, M_PI * r1 * r2);
+  }
+
+  // r = gamma * (log(q) / q)^(1/d), gamma > 2 * (1 + 1/d)^(1/d) *
+  // (measure / unit ball volume)^(1/d) with d = 2
+  const double gamma =
+      rewire_factor_ * 2.0 * std::sqrt((1.0 + 1.0 / 2.0) * measure / M_PI);
+  return gamma * std::sqrt(std::log(q) / q);
+}
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
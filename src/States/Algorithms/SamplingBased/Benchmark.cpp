@@ -0,0 +1,533 @@
+#include "States/Algorithms/SamplingBased/Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+#include "States/Algorithms/SamplingBased/BIT_STAR/BIT_STAR.h"
+#include "States/Algorithms/SamplingBased/INFORMED_RRT_STAR/INFORMED_RRT_STAR.h"
+#include "States/Algorithms/SamplingBased/RRT/RRT.h"
+#include "States/Algorithms/SamplingBased/RRT_CONNECT/RRT_CONNECT.h"
+#include "States/Algorithms/SamplingBased/RRT_STAR/RRT_STAR.h"
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+
+// plot colors of the planners, in the order of BENCHMARK_PLANNERS
+const ImU32 PLOT_COLORS[] = {IM_COL32(230, 25, 75, 255),
+                             IM_COL32(0, 130, 200, 255),
+                             IM_COL32(60, 180, 75, 255),
+                             IM_COL32(245, 130, 48, 255),
+                             IM_COL32(145, 30, 180, 255)};
+
+std::unique_ptr<SamplingBased> makePlanner(
+    int planner_id, std::shared_ptr<gui::LoggerPanel> logger_panel,
+    std::shared_ptr<ThreadPool> thread_pool) {
+  const std::string &name = BENCHMARK_PLANNERS[planner_id];
+  switch (planner_id) {
+    case BENCHMARK_RRT_STAR:
+      return std::make_unique<RRT_STAR>(logger_panel, thread_pool, name);
+    case BENCHMARK_RRT_CONNECT:
+      return std::make_unique<RRT_CONNECT>(logger_panel, thread_pool, name);
+    case BENCHMARK_INFORMED_RRT_STAR:
+      return std::make_unique<INFORMED_RRT_STAR>(logger_panel, thread_pool,
+                                                 name);
+    case BENCHMARK_BIT_STAR:
+      return std::make_unique<BIT_STAR>(logger_panel, thread_pool, name);
+    case BENCHMARK_RRT:
+    default:
+      return std::make_unique<RRT>(logger_panel, thread_pool, name);
+  }
+}
+
+// q-quantile with linear interpolation, infinite once any of the two
+// values around it is
+double quantile(std::vector<double> &values, double q) {
+  if (values.empty()) return INF;
+  std::sort(values.begin(), values.end());
+  const double pos = q * static_cast<double>(values.size() - 1u);
+  const std::size_t lo = static_cast<std::size_t>(std::floor(pos));
+  const std::size_t hi = static_cast<std::size_t>(std::ceil(pos));
+  if (values[hi] == INF) return INF;
+  return values[lo] + (values[hi] - values[lo]) * (pos - lo);
+}
+}  // namespace
+
+// Constructor
+Benchmark::Benchmark(std::shared_ptr<gui::LoggerPanel> logger_panel,
+                     std::shared_ptr<ThreadPool> thread_pool)
+    : logger_panel_{logger_panel},
+      thread_pool_{thread_pool},
+      is_selected_(BENCHMARK_PLANNERS.size(), 0u),
+      no_of_runs_{10},
+      first_seed_{1},
+      time_limit_{1.0},
+      run_time_limit_{1.0},
+      total_time_{0.0},
+      no_of_planned_runs_{0u} {
+  is_selected_[BENCHMARK_RRT] = is_selected_[BENCHMARK_RRT_STAR] = 1u;
+  std::snprintf(filename_, sizeof(filename_), "%s", "planner_benchmark");
+}
+
+// Destructor
+Benchmark::~Benchmark() { stop(); }
+
+bool Benchmark::isRunning() const { return is_running_.load(); }
+
+void Benchmark::start(const SamplingBased &host) {
+  if (isRunning()) return;
+
+  // every planner gets its own copy of the map of the host
+  std::vector<std::unique_ptr<SamplingBased>> planners;
+  std::vector<int> planner_ids;
+  auto silent_logger = std::make_shared<gui::LoggerPanel>();
+  for (int id = 0; id < static_cast<int>(BENCHMARK_PLANNERS.size()); ++id) {
+    if (!is_selected_[id]) continue;
+    std::unique_ptr<SamplingBased> planner =
+        makePlanner(id, silent_logger, thread_pool_);
+    planner->map_width_ = host.map_width_;
+    planner->map_height_ = host.map_height_;
+    planner->obstacles_ = host.obstacles_;
+    planner->updateObstacles();
+    planner->start_vertex_->x = host.start_vertex_->x;
+    planner->start_vertex_->y = host.start_vertex_->y;
+    planner->goal_vertex_->x = host.goal_vertex_->x;
+    planner->goal_vertex_->y = host.goal_vertex_->y;
+    planner->max_iterations_ = host.max_iterations_;
+    planner->nn_backend_ = host.nn_backend_;
+    planner->nn_ = makeNearestNeighbors(host.nn_backend_);
+    planner->sampler_ = host.sampler_;
+    if (planner->supportsGoalBias()) planner->goal_bias_ = host.goal_bias_;
+    planner->no_of_threads_ = 1;
+    planner->is_recording_ = false;
+    planner->smooth_path_ = false;
+    planners.push_back(std::move(planner));
+    planner_ids.push_back(id);
+  }
+  if (planners.empty()) {
+    logger_panel_->info("Select at least one planner to benchmark.");
+    return;
+  }
+
+  char buf[64];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", std::localtime(&now));
+  start_time_ = buf;
+  run_time_limit_ = time_limit_;
+  common_properties_ = {
+      "map width INTEGER = " + std::to_string(host.map_width_),
+      "map height INTEGER = " + std::to_string(host.map_height_),
+      "obstacles INTEGER = " + std::to_string(host.obstacles_.size()),
+      "max iterations INTEGER = " + std::to_string(host.max_iterations_),
+      "nearest neighbours = " + NN_BACKEND_NAMES[host.nn_backend_],
+      "sampler = " + SAMPLER_NAMES[host.sampler_]};
+
+  {
+    std::lock_guard<std::mutex> lock(runs_mutex_);
+    runs_.clear();
+    total_time_ = 0.0;
+    no_of_planned_runs_ = planners.size() * no_of_runs_;
+  }
+  is_stopped_ = false;
+  is_running_ = true;
+  logger_panel_->info("Benchmark started: " +
+                      std::to_string(no_of_planned_runs_) + " runs of " +
+                      std::to_string(run_time_limit_) + " s.");
+
+  job_ = thread_pool_->submit(
+      [this, planners = std::move(planners), planner_ids,
+       no_of_runs = no_of_runs_, first_seed = first_seed_]() mutable {
+        runAll(std::move(planners), planner_ids, no_of_runs, first_seed);
+      });
+}
+
+void Benchmark::stop() {
+  is_stopped_ = true;
+  if (job_.valid()) job_.get();
+}
+
+void Benchmark::update() {
+  if (!job_.valid() || job_.wait_for(std::chrono::seconds(0)) !=
+                           std::future_status::ready) {
+    return;
+  }
+  job_.get();
+
+  std::lock_guard<std::mutex> lock(runs_mutex_);
+  char buf[128];
+  std::snprintf(buf, sizeof(buf), "Benchmark %s: %zu/%zu runs in %.1f s",
+                is_stopped_ ? "stopped" : "finished", runs_.size(),
+                no_of_planned_runs_, total_time_);
+  logger_panel_->info(buf);
+}
+
+void Benchmark::runAll(std::vector<std::unique_ptr<SamplingBased>> planners,
+                       std::vector<int> planner_ids, int no_of_runs,
+                       int first_seed) {
+  // the planners grow their trees from this thread only
+  SamplingBased::worker_index_ = 0u;
+  const auto t0 = Clock::now();
+
+  // the planners take turns per seed, so drifts of the machine hit all alike
+  for (int r = 0; r < no_of_runs && !is_stopped_; ++r) {
+    const std::uint32_t seed = static_cast<std::uint32_t>(first_seed + r);
+    for (std::size_t p = 0u; p < planners.size(); ++p) {
+      BenchmarkRun run = runOnce(*planners[p], planner_ids[p], seed);
+      if (is_stopped_) break;
+      std::lock_guard<std::mutex> lock(runs_mutex_);
+      runs_.push_back(std::move(run));
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(runs_mutex_);
+  total_time_ = std::chrono::duration<double>(Clock::now() - t0).count();
+  is_running_ = false;
+}
+
+BenchmarkRun Benchmark::runOnce(SamplingBased &planner, int planner_id,
+                                std::uint32_t seed) const {
+  BenchmarkRun run{planner_id, seed, INF, 0.0, {}};
+  run.samples.reserve(BENCHMARK_SAMPLES);
+
+  planner.seed_ = static_cast<int>(seed);
+  planner.initRun();
+  Vertex &start = *planner.start_vertex_;
+  Vertex &goal = *planner.goal_vertex_;
+
+  const double interval = run_time_limit_ / BENCHMARK_SAMPLES;
+  auto record_sample = [&]() {
+    run.samples.push_back(
+        {interval * (run.samples.size() + 1u), planner.bestSolutionCost(goal),
+         planner.vertices_.size(), planner.no_of_collision_checks_.load(),
+         planner.curr_iter_no_.load(std::memory_order_relaxed)});
+  };
+
+  // a planner that is done keeps its last state until the time limit
+  const auto t0 = Clock::now();
+  bool solved = false;
+  while (run.samples.size() < BENCHMARK_SAMPLES && !is_stopped_) {
+    if (!solved) {
+      planner.updatePlanner(solved, start, goal);
+      run.time = std::chrono::duration<double>(Clock::now() - t0).count();
+      // RRT* & Informed RRT* link the goal only every few iterations
+      if (run.time_to_first_solution == INF &&
+          planner.bestSolutionCost(goal) != INF) {
+        run.time_to_first_solution = run.time;
+      }
+    }
+    while (run.samples.size() < BENCHMARK_SAMPLES &&
+           (solved || run.time >= interval * (run.samples.size() + 1u))) {
+      record_sample();
+    }
+  }
+  run.time = std::min(run.time, run_time_limit_);
+  return run;
+}
+
+void Benchmark::renderGui(const SamplingBased &host) {
+  ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(8.f, 8.f));
+  if (ImGui::CollapsingHeader("Benchmark")) {
+    ImGui::Indent(8.f);
+    ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 6.f);
+    ImGui::PushStyleVar(ImGuiStyleVar_ItemInnerSpacing, ImVec2(2.f, 4.f));
+
+    const bool is_running = isRunning();
+    if (is_running) ImGui::BeginDisabled();
+    for (std::size_t i = 0u; i < BENCHMARK_PLANNERS.size(); ++i) {
+      bool selected = is_selected_[i] != 0u;
+      if (ImGui::Checkbox(BENCHMARK_PLANNERS[i].c_str(), &selected)) {
+        is_selected_[i] = selected ? 1u : 0u;
+      }
+      if (i % 3u != 2u && i + 1u < BENCHMARK_PLANNERS.size()) {
+        ImGui::SameLine();
+      }
+    }
+    gui::inputInt("runs", &no_of_runs_, 1, 10000, 1, 10,
+                  "Runs per planner, run k uses seed first_seed + k");
+    gui::inputInt("first_seed", &first_seed_, 1, 1000000000, 1, 100,
+                  "Seed of the first run");
+    gui::inputDouble("time_limit", &time_limit_, 0.01, 600.0, 0.1, 1.0,
+                     "Seconds per run, runs also end after max_iterations",
+                     "%.2f s");
+    if (is_running) ImGui::EndDisabled();
+
+    if (is_running) {
+      if (ImGui::Button("Stop Benchmark")) stop();
+      ImGui::SameLine();
+      std::lock_guard<std::mutex> lock(runs_mutex_);
+      ImGui::Text("%zu/%zu runs", runs_.size(), no_of_planned_runs_);
+    } else {
+      // runs are timed, so they don't share the cores with the planner
+      if (host.is_running_) ImGui::BeginDisabled();
+      if (ImGui::Button("Run Benchmark")) start(host);
+      if (host.is_running_) ImGui::EndDisabled();
+      ImGui::SameLine();
+      gui::HelpMarker(
+          "Runs the selected planners on this map with the common "
+          "configuration.\nPlanner specific parameters keep their "
+          "defaults.");
+    }
+
+    ImGui::InputText("##benchmark_filename", filename_, sizeof(filename_));
+    ImGui::SameLine();
+    gui::HelpMarker("Exported files get a .csv or .log extension");
+    if (is_running) ImGui::BeginDisabled();
+    if (ImGui::Button("Export CSV")) {
+      const std::string filename = std::string(filename_) + ".csv";
+      logger_panel_->info(exportCsv(filename)
+                              ? "Saved benchmark runs to " + filename
+                              : "Failed to save benchmark runs to " + filename);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Export Log")) {
+      const std::string filename = std::string(filename_) + ".log";
+      logger_panel_->info(exportLog(filename)
+                              ? "Saved benchmark log to " + filename
+                              : "Failed to save benchmark log to " + filename);
+    }
+    if (is_running) ImGui::EndDisabled();
+
+    ImGui::PopStyleVar(2);
+    ImGui::Unindent(8.f);
+    ImGui::Spacing();
+  }
+  ImGui::PopStyleVar();
+}
+
+void Benchmark::renderStats() {
+  std::vector<BenchmarkRun> runs;
+  {
+    std::lock_guard<std::mutex> lock(runs_mutex_);
+    if (runs_.empty()) return;
+    runs = runs_;
+  }
+
+  ImGui::Separator();
+  ImGui::Text("Benchmark (%zu runs, %.2f s each)", runs.size(),
+              run_time_limit_);
+  if (ImGui::BeginTable("##benchmark", 4)) {
+    ImGui::TableSetupColumn("planner");
+    ImGui::TableSetupColumn("solved");
+    ImGui::TableSetupColumn("first solution");
+    ImGui::TableSetupColumn("final cost");
+    ImGui::TableHeadersRow();
+    for (int id = 0; id < static_cast<int>(BENCHMARK_PLANNERS.size()); ++id) {
+      std::vector<double> first, final_cost;
+      for (const BenchmarkRun &run : runs) {
+        if (run.planner != id) continue;
+        first.push_back(run.time_to_first_solution);
+        final_cost.push_back(run.samples.back().best_cost);
+      }
+      if (first.empty()) continue;
+      const std::size_t no_of_runs = first.size();
+      const std::size_t solved = static_cast<std::size_t>(
+          std::count_if(first.begin(), first.end(),
+                        [](double t) { return t < INF; }));
+      const double median_first = quantile(first, 0.5);
+      const double median_cost = quantile(final_cost, 0.5);
+
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::Text("%s", BENCHMARK_PLANNERS[id].c_str());
+      ImGui::TableNextColumn();
+      ImGui::Text("%zu/%zu", solved, no_of_runs);
+      ImGui::TableNextColumn();
+      if (median_first < INF) {
+        ImGui::Text("%.1f ms", 1e3 * median_first);
+      } else {
+        ImGui::Text("-");
+      }
+      ImGui::TableNextColumn();
+      if (median_cost < INF) {
+        ImGui::Text("%.4f", median_cost);
+      } else {
+        ImGui::Text("-");
+      }
+    }
+    ImGui::EndTable();
+  }
+  renderCostPlot(runs);
+}
+
+void Benchmark::renderCostPlot(const std::vector<BenchmarkRun> &runs) const {
+  // median & quartiles of every planner at every sample time
+  struct Curves {
+    int planner;
+    std::vector<double> q[3];
+  };
+  const double quantiles[3] = {0.25, 0.5, 0.75};
+  std::vector<Curves> curves;
+  double lo = INF, hi = -INF;
+  std::vector<double> costs;
+  for (int id = 0; id < static_cast<int>(BENCHMARK_PLANNERS.size()); ++id) {
+    Curves c{id, {}};
+    for (std::size_t k = 0u; k < BENCHMARK_SAMPLES; ++k) {
+      costs.clear();
+      for (const BenchmarkRun &run : runs) {
+        if (run.planner == id) costs.push_back(run.samples[k].best_cost);
+      }
+      if (costs.empty()) break;
+      for (int i = 0; i < 3; ++i) {
+        const double v = quantile(costs, quantiles[i]);
+        c.q[i].push_back(v);
+        if (v < INF) {
+          lo = std::min(lo, v);
+          hi = std::max(hi, v);
+        }
+      }
+    }
+    if (!c.q[1].empty()) curves.push_back(std::move(c));
+  }
+  if (lo == INF) {
+    ImGui::Text("No solutions yet");
+    return;
+  }
+  if (hi - lo < 1e-9) {
+    lo -= 0.5;
+    hi += 0.5;
+  }
+
+  const ImVec2 origin = ImGui::GetCursorScreenPos();
+  const ImVec2 size(std::max(ImGui::GetContentRegionAvail().x, 100.f), 160.f);
+  ImGui::Dummy(size);
+  ImDrawList *draw_list = ImGui::GetWindowDrawList();
+  draw_list->AddRect(origin, ImVec2(origin.x + size.x, origin.y + size.y),
+                     IM_COL32(128, 128, 128, 255));
+  auto to_screen = [&](std::size_t k, double cost) {
+    return ImVec2(
+        origin.x + size.x * static_cast<float>(k + 1u) / BENCHMARK_SAMPLES,
+        origin.y + size.y * static_cast<float>(1.0 - (cost - lo) / (hi - lo)));
+  };
+
+  // quartiles thin & faded, the median on top of them
+  for (const Curves &c : curves) {
+    for (int i = 0; i < 3; ++i) {
+      const ImU32 color =
+          i == 1 ? PLOT_COLORS[c.planner]
+                 : (PLOT_COLORS[c.planner] & 0x00FFFFFFu) | (96u << 24);
+      const std::vector<double> &q = c.q[i];
+      for (std::size_t k = 1u; k < q.size(); ++k) {
+        if (q[k - 1u] == INF || q[k] == INF) continue;
+        draw_list->AddLine(to_screen(k - 1u, q[k - 1u]), to_screen(k, q[k]),
+                           color, i == 1 ? 2.f : 1.f);
+      }
+    }
+  }
+
+  ImGui::Text("Best cost %.4f - %.4f over %.2f s", lo, hi, run_time_limit_);
+  for (const Curves &c : curves) {
+    const ImU32 color = PLOT_COLORS[c.planner];
+    ImGui::TextColored(
+        ImVec4((color & 0xFFu) / 255.f, ((color >> 8) & 0xFFu) / 255.f,
+               ((color >> 16) & 0xFFu) / 255.f, 1.f),
+        "%s: median, 25%% & 75%% quantiles",
+        BENCHMARK_PLANNERS[c.planner].c_str());
+  }
+}
+
+bool Benchmark::exportCsv(const std::string &filename) const {
+  std::ofstream out(filename);
+  if (!out) return false;
+  out << "planner,seed,time_to_first_solution,time,best_cost,tree_size,"
+         "collision_checks,iterations\n";
+  std::lock_guard<std::mutex> lock(runs_mutex_);
+  for (const BenchmarkRun &run : runs_) {
+    for (const BenchmarkSample &s : run.samples) {
+      out << BENCHMARK_PLANNERS[run.planner] << ',' << run.seed << ','
+          << run.time_to_first_solution << ',' << s.time << ',' << s.best_cost
+          << ',' << s.tree_size << ',' << s.collision_checks << ','
+          << s.iterations << '\n';
+    }
+  }
+  return static_cast<bool>(out);
+}
+
+bool Benchmark::exportLog(const std::string &filename) const {
+  std::ofstream out(filename);
+  if (!out) return false;
+  std::lock_guard<std::mutex> lock(runs_mutex_);
+
+  // header of an OMPL benchmark log, version 1.5 of the format
+  out << "OMPL version 1.5.0\n";
+  out << "Experiment path_finding_visualizer\n";
+  out << "Running on " << std::thread::hardware_concurrency()
+      << " hardware threads\n";
+  out << "Starting at " << start_time_ << '\n';
+  out << "<<<|\n2D planning map, see the common properties\n|>>>\n";
+  out << "<<<|\n|>>>\n";
+  out << first_seed_ << " is the random seed\n";
+  out << run_time_limit_ << " seconds per run\n";
+  out << "0 MB per run\n";
+  out << no_of_runs_ << " runs per planner\n";
+  out << total_time_ << " seconds spent to collect the data\n";
+  out << "0 enum types\n";
+
+  std::vector<int> planner_ids;
+  for (const BenchmarkRun &run : runs_) {
+    if (std::find(planner_ids.begin(), planner_ids.end(), run.planner) ==
+        planner_ids.end()) {
+      planner_ids.push_back(run.planner);
+    }
+  }
+  out << planner_ids.size() << " planners\n";
+  for (const int id : planner_ids) {
+    out << BENCHMARK_PLANNERS[id] << '\n';
+    out << common_properties_.size() << " common properties\n";
+    for (const std::string &p : common_properties_) out << p << '\n';
+
+    out << "8 properties for each run\n"
+           "seed INTEGER\n"
+           "time REAL\n"
+           "solved BOOLEAN\n"
+           "time to first solution REAL\n"
+           "best cost REAL\n"
+           "graph states INTEGER\n"
+           "collision checks INTEGER\n"
+           "iterations INTEGER\n";
+    const std::size_t no_of_runs = static_cast<std::size_t>(
+        std::count_if(runs_.begin(), runs_.end(), [id](const BenchmarkRun &r) {
+          return r.planner == id;
+        }));
+    out << no_of_runs << " runs\n";
+    for (const BenchmarkRun &run : runs_) {
+      if (run.planner != id) continue;
+      const BenchmarkSample &last = run.samples.back();
+      out << run.seed << "; " << run.time << "; "
+          << (run.time_to_first_solution < INF ? 1 : 0) << "; "
+          << run.time_to_first_solution << "; " << last.best_cost << "; "
+          << last.tree_size << "; " << last.collision_checks << "; "
+          << last.iterations << "; \n";
+    }
+
+    out << "5 progress properties for each run\n"
+           "time REAL\n"
+           "best cost REAL\n"
+           "graph states INTEGER\n"
+           "collision checks INTEGER\n"
+           "iterations INTEGER\n";
+    out << no_of_runs << " runs\n";
+    for (const BenchmarkRun &run : runs_) {
+      if (run.planner != id) continue;
+      for (const BenchmarkSample &s : run.samples) {
+        out << s.time << ',' << s.best_cost << ',' << s.tree_size << ','
+            << s.collision_checks << ',' << s.iterations << ",;";
+      }
+      out << '\n';
+    }
+    out << ".\n";
+  }
+  return static_cast<bool>(out);
+}
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
@@ -0,0 +1,140 @@
+#include "States/Algorithms/SamplingBased/INFORMED_RRT_STAR/INFORMED_RRT_STAR.h"
+
+#include <algorithm>
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+// Constructor
+INFORMED_RRT_STAR::INFORMED_RRT_STAR(
+    std::shared_ptr<gui::LoggerPanel> logger_panel,
+    std::shared_ptr<ThreadPool> thread_pool, const std::string &name)
+    : RRT_STAR(logger_panel, thread_pool, name),
+      best_cost_{std::numeric_limits<double>::infinity()},
+      pruned_cost_{std::numeric_limits<double>::infinity()} {
+  initParameters();
+  initialize();
+}
+
+// Destructor
+INFORMED_RRT_STAR::~INFORMED_RRT_STAR() {}
+
+void INFORMED_RRT_STAR::initParameters() {
+  RRT_STAR::initParameters();
+  prune_threshold_ = 0.05;
+}
+
+// override initPlanner() function
+void INFORMED_RRT_STAR::initPlanner() {
+  RRT_STAR::initPlanner();
+  best_cost_ = pruned_cost_ = std::numeric_limits<double>::infinity();
+  no_of_pruned_ = 0u;
+}
+
+void INFORMED_RRT_STAR::renderParametersGui() {
+  RRT_STAR::renderParametersGui();
+  gui::inputDouble("prune_threshold", &prune_threshold_, 0.0, 1.0, 0.01, 0.1,
+                   "Prune the tree once the solution cost improved by this "
+                   "fraction",
+                   "%.2f");
+}
+
+void INFORMED_RRT_STAR::renderStats() {
+  ImGui::Text("Pruned vertices: %zu", no_of_pruned_.load());
+  RRT_STAR::renderStats();
+}
+
+void INFORMED_RRT_STAR::updatePlanner(bool &solved, Vertex &start,
+                                      Vertex &goal) {
+  RRT_STAR::updatePlanner(solved, start, goal);
+  if (goal.parent == NO_VERTEX) return;
+
+  // costs keep dropping through rewires even if the goal parent stays
+  best_cost_ = cost(goal.parent) + distance(treeVertex(goal.parent), goal);
+  if (best_cost_ < pruned_cost_ * (1.0 - prune_threshold_)) {
+    prune(goal);
+    pruned_cost_ = best_cost_;
+  }
+}
+
+void INFORMED_RRT_STAR::sample(Vertex &v) {
+  const double c_min = distance(*start_vertex_, *goal_vertex_);
+  if (best_cost_ == std::numeric_limits<double>::infinity() || c_min <= 0.0) {
+    RRT::sample(v);
+    return;
+  }
+
+  // ellipse with the start & goal as foci and best_cost_ as major axis
+  const double r1 = best_cost_ / 2.0;
+  const double r2 =
+      std::sqrt(std::max(best_cost_ * best_cost_ - c_min * c_min, 0.0)) / 2.0;
+  const double center_x = (start_vertex_->x + goal_vertex_->x) / 2.0;
+  const double center_y = (start_vertex_->y + goal_vertex_->y) / 2.0;
+  const double cos_a = (goal_vertex_->x - start_vertex_->x) / c_min;
+  const double sin_a = (goal_vertex_->y - start_vertex_->y) / c_min;
+
+  // points of the sample stream mapped uniformly onto the unit disk, then
+  // stretched & rotated onto the ellipse, samples outside the map are
+  // rejected
+  for (int attempt = 0; attempt < 100; ++attempt) {
+    double u1, u2;
+    nextSample(u1, u2);
+    const double r = std::sqrt(u1);
+    const double theta = 2.0 * M_PI * u2;
+    const double ex = r1 * r * std::cos(theta);
+    const double ey = r2 * r * std::sin(theta);
+    v.x = center_x + cos_a * ex - sin_a * ey;
+    v.y = center_y + sin_a * ex + cos_a * ey;
+    if (v.x >= 0.0 && v.x <= 1.0 && v.y >= 0.0 && v.y <= 1.0) return;
+  }
+  RRT::sample(v);
+}
+
+void INFORMED_RRT_STAR::prune(const Vertex &goal) {
+  std::unique_lock<std::shared_mutex> tree_lck(tree_mutex_);
+  std::unique_lock<std::shared_mutex> nn_lck(nn_mutex_);
+
+  // is_pruned_ is sized to the iteration limit by RRT_STAR
+  const std::uint32_t n = static_cast<std::uint32_t>(vertices_.size());
+
+  // a vertex that cannot improve the solution leaves the tree with its whole
+  // subtree, the tolerance keeps the solution path against rounding errors
+  // of the propagated costs
+  std::size_t pruned = 0u;
+  std::vector<std::uint32_t> subtree;
+  for (std::uint32_t id = 0u; id < n; ++id) {
+    if (is_pruned_[id]) continue;
+    if (cost(id) + distance(treeVertex(id), goal) <= best_cost_ + 1e-9) {
+      continue;
+    }
+    subtree.assign(1u, id);
+    for (std::size_t k = 0u; k < subtree.size(); ++k) {
+      for (std::uint32_t child = vertices_.first_child[subtree[k]];
+           child != NO_VERTEX; child = vertices_.next_sibling[child]) {
+        subtree.push_back(child);
+      }
+    }
+    for (const std::uint32_t v : subtree) {
+      vertices_.detach(v);
+      is_pruned_[v] = 1u;
+      recordPrune(v);
+    }
+    pruned += subtree.size();
+  }
+  if (pruned == 0u) return;
+
+  // rebuild the index & solution candidates from the remaining vertices
+  nn_->clear();
+  for (std::uint32_t id = 0u; id < n; ++id) {
+    if (!is_pruned_[id]) nn_->add(id, vertices_.x[id], vertices_.y[id]);
+  }
+  x_soln_.erase(std::remove_if(x_soln_.begin(), x_soln_.end(),
+                               [this](std::uint32_t id) {
+                                 return is_pruned_[id] != 0u;
+                               }),
+                x_soln_.end());
+  no_of_pruned_ += pruned;
+}
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
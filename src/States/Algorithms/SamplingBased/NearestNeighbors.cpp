@@ -0,0 +1,249 @@
+#include "States/Algorithms/SamplingBased/NearestNeighbors.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "States/Algorithms/SamplingBased/DistanceKernels.h"
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+namespace {
+inline double squaredDistance(double x1, double y1, double x2, double y2) {
+  return (x1 - x2) * (x1 - x2) + (y1 - y2) * (y1 - y2);
+}
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////
+//   LinearNN
+////////////////////////////////////////////////////////////////////////
+
+void LinearNN::clear() {
+  xs_.clear();
+  ys_.clear();
+  ids_.clear();
+}
+
+void LinearNN::reserve(std::size_t n) {
+  xs_.reserve(n);
+  ys_.reserve(n);
+  ids_.reserve(n);
+}
+
+void LinearNN::add(std::uint32_t id, double x, double y) {
+  xs_.push_back(x);
+  ys_.push_back(y);
+  ids_.push_back(id);
+}
+
+std::uint32_t LinearNN::nearest(double x, double y) const {
+  double min_dist = std::numeric_limits<double>::infinity();
+  const std::size_t i = argminSquaredDistance(xs_.data(), ys_.data(),
+                                              ids_.size(), x, y, min_dist);
+  return i < ids_.size() ? ids_[i] : 0u;
+}
+
+void LinearNN::radius(double x, double y, double r,
+                      std::vector<std::uint32_t> &ids) const {
+  withinRadius(xs_.data(), ys_.data(), ids_.data(), ids_.size(), x, y, r * r,
+               ids);
+}
+
+////////////////////////////////////////////////////////////////////////
+//   KdTreeNN
+////////////////////////////////////////////////////////////////////////
+
+void KdTreeNN::clear() { nodes_.clear(); }
+
+void KdTreeNN::reserve(std::size_t n) { nodes_.reserve(n); }
+
+void KdTreeNN::add(std::uint32_t id, double x, double y) {
+  const std::int32_t new_node = static_cast<std::int32_t>(nodes_.size());
+  nodes_.push_back({{x, y}, id, {NO_CHILD, NO_CHILD}});
+  if (new_node == 0) return;
+
+  // descend to the leaf the point falls into
+  const double p[2] = {x, y};
+  std::int32_t node = 0;
+  for (int depth = 0;; ++depth) {
+    const int axis = depth & 1;
+    const int side = p[axis] < nodes_[node].p[axis] ? 0 : 1;
+    if (nodes_[node].child[side] == NO_CHILD) {
+      nodes_[node].child[side] = new_node;
+      return;
+    }
+    node = nodes_[node].child[side];
+  }
+}
+
+std::uint32_t KdTreeNN::nearest(double x, double y) const {
+  if (nodes_.empty()) return 0u;
+
+  const double q[2] = {x, y};
+  double min_dist = std::numeric_limits<double>::infinity();
+  std::uint32_t nearest_id = 0u;
+
+  // per thread, so that queries can run concurrently
+  thread_local std::vector<StackEntry> stack;
+  stack.clear();
+  stack.push_back({0, 0, 0.0});
+  while (!stack.empty()) {
+    const StackEntry e = stack.back();
+    stack.pop_back();
+    if (e.node == NO_CHILD || e.bound >= min_dist) continue;
+
+    const Node &n = nodes_[e.node];
+    const double d = squaredDistance(n.p[0], n.p[1], x, y);
+    if (d < min_dist) {
+      min_dist = d;
+      nearest_id = n.id;
+    }
+
+    // the far side is pushed first so that the near side is searched first
+    const int axis = e.depth & 1;
+    const double diff = q[axis] - n.p[axis];
+    const int near_side = diff < 0.0 ? 0 : 1;
+    stack.push_back(
+        {n.child[1 - near_side], e.depth + 1, std::max(e.bound, diff * diff)});
+    stack.push_back({n.child[near_side], e.depth + 1, e.bound});
+  }
+  return nearest_id;
+}
+
+void KdTreeNN::radius(double x, double y, double r,
+                      std::vector<std::uint32_t> &ids) const {
+  if (nodes_.empty()) return;
+
+  const double q[2] = {x, y};
+  const double r2 = r * r;
+
+  // per thread, so that queries can run concurrently
+  thread_local std::vector<StackEntry> stack;
+  stack.clear();
+  stack.push_back({0, 0, 0.0});
+  while (!stack.empty()) {
+    const StackEntry e = stack.back();
+    stack.pop_back();
+    if (e.node == NO_CHILD) continue;
+
+    const Node &n = nodes_[e.node];
+    if (squaredDistance(n.p[0], n.p[1], x, y) < r2) ids.push_back(n.id);
+
+    const int axis = e.depth & 1;
+    const double diff = q[axis] - n.p[axis];
+    const int near_side = diff < 0.0 ? 0 : 1;
+    stack.push_back({n.child[near_side], e.depth + 1, 0.0});
+    if (diff * diff < r2) {
+      stack.push_back({n.child[1 - near_side], e.depth + 1, 0.0});
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+//   GridNN
+////////////////////////////////////////////////////////////////////////
+
+namespace {
+// average number of vertices per bucket before the resolution doubles
+constexpr std::size_t MAX_BUCKET_LOAD = 4u;
+constexpr int MIN_RESOLUTION = 8;
+constexpr int MAX_RESOLUTION = 1024;
+}  // namespace
+
+GridNN::GridNN() { rebuild(MIN_RESOLUTION); }
+
+void GridNN::clear() {
+  points_.clear();
+  rebuild(MIN_RESOLUTION);
+}
+
+void GridNN::reserve(std::size_t n) {
+  // buckets still grow as the resolution doubles
+  points_.reserve(n);
+}
+
+int GridNN::cellCoord(double v) const {
+  return std::min(std::max(static_cast<int>(v * resolution_), 0),
+                  resolution_ - 1);
+}
+
+void GridNN::rebuild(int resolution) {
+  resolution_ = resolution;
+  buckets_.assign(static_cast<std::size_t>(resolution) * resolution, {});
+  for (const Point &p : points_) {
+    buckets_[static_cast<std::size_t>(cellCoord(p.x)) * resolution_ +
+             cellCoord(p.y)]
+        .push(p);
+  }
+}
+
+void GridNN::add(std::uint32_t id, double x, double y) {
+  points_.push_back({x, y, id});
+  if (points_.size() > MAX_BUCKET_LOAD * buckets_.size() &&
+      resolution_ < MAX_RESOLUTION) {
+    rebuild(resolution_ * 2);
+    return;
+  }
+  buckets_[static_cast<std::size_t>(cellCoord(x)) * resolution_ +
+           cellCoord(y)]
+      .push(points_.back());
+}
+
+std::uint32_t GridNN::nearest(double x, double y) const {
+  const int cx = cellCoord(x), cy = cellCoord(y);
+  const double cell_size = 1.0 / resolution_;
+  double min_dist = std::numeric_limits<double>::infinity();
+  std::uint32_t nearest_id = 0u;
+
+  // search rings of buckets around the query bucket
+  for (int k = 0; k < resolution_; ++k) {
+    for (int i = std::max(cx - k, 0); i <= std::min(cx + k, resolution_ - 1);
+         ++i) {
+      for (int j = std::max(cy - k, 0); j <= std::min(cy + k, resolution_ - 1);
+           ++j) {
+        // only the buckets on the border of the ring
+        if (std::max(std::abs(i - cx), std::abs(j - cy)) != k) continue;
+        const Bucket &b =
+            buckets_[static_cast<std::size_t>(i) * resolution_ + j];
+        const std::size_t p = argminSquaredDistance(
+            b.xs.data(), b.ys.data(), b.ids.size(), x, y, min_dist);
+        if (p < b.ids.size()) nearest_id = b.ids[p];
+      }
+    }
+
+    // buckets of the next ring are at least k buckets away
+    const double ring_dist = k * cell_size;
+    if (min_dist <= ring_dist * ring_dist) break;
+  }
+  return nearest_id;
+}
+
+void GridNN::radius(double x, double y, double r,
+                    std::vector<std::uint32_t> &ids) const {
+  const double r2 = r * r;
+  const int i_min = cellCoord(x - r), i_max = cellCoord(x + r);
+  const int j_min = cellCoord(y - r), j_max = cellCoord(y + r);
+  for (int i = i_min; i <= i_max; ++i) {
+    for (int j = j_min; j <= j_max; ++j) {
+      const Bucket &b = buckets_[static_cast<std::size_t>(i) * resolution_ + j];
+      withinRadius(b.xs.data(), b.ys.data(), b.ids.data(), b.ids.size(), x, y,
+                   r2, ids);
+    }
+  }
+}
+
+std::unique_ptr<NearestNeighbors> makeNearestNeighbors(int backend) {
+  switch (backend) {
+    case NN_LINEAR:
+      return std::make_unique<LinearNN>();
+    case NN_GRID:
+      return std::make_unique<GridNN>();
+    case NN_KDTREE:
+    default:
+      return std::make_unique<KdTreeNN>();
+  }
+}
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
@@ -0,0 +1,282 @@
+#include "States/Algorithms/SamplingBased/ObstacleSet.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+namespace {
+// obstacles per leaf of the hierarchy
+constexpr std::uint32_t LEAF_SIZE = 4u;
+// deeper than any median split of 2^32 obstacles
+constexpr int MAX_DEPTH = 64;
+
+template <typename Box>
+bool boxContains(const Box &b, double x, double y) {
+  return x >= b.min_x && x <= b.max_x && y >= b.min_y && y <= b.max_y;
+}
+
+// slab test of the segment from (x0, y0) along (dx, dy) against a box
+template <typename Box>
+bool segmentHitsBox(const Box &b, double x0, double y0, double dx, double dy,
+                    double inv_dx, double inv_dy) {
+  double t_min = 0.0, t_max = 1.0;
+  if (dx == 0.0) {
+    if (x0 < b.min_x || x0 > b.max_x) return false;
+  } else {
+    double t1 = (b.min_x - x0) * inv_dx, t2 = (b.max_x - x0) * inv_dx;
+    if (t1 > t2) std::swap(t1, t2);
+    t_min = std::max(t_min, t1);
+    t_max = std::min(t_max, t2);
+    if (t_min > t_max) return false;
+  }
+  if (dy == 0.0) {
+    if (y0 < b.min_y || y0 > b.max_y) return false;
+  } else {
+    double t1 = (b.min_y - y0) * inv_dy, t2 = (b.max_y - y0) * inv_dy;
+    if (t1 > t2) std::swap(t1, t2);
+    t_min = std::max(t_min, t1);
+    t_max = std::min(t_max, t2);
+    if (t_min > t_max) return false;
+  }
+  return true;
+}
+}  // namespace
+
+void ObstacleSet::addRect(float x, float y, float w, float h) {
+  const float x0 = std::min(x, x + w), x1 = std::max(x, x + w);
+  const float y0 = std::min(y, y + h), y1 = std::max(y, y + h);
+  const std::uint32_t first = static_cast<std::uint32_t>(xs_.size());
+  xs_.insert(xs_.end(), {x0, x1, x1, x0});
+  ys_.insert(ys_.end(), {y0, y0, y1, y1});
+  appendObstacle(first, true);
+}
+
+bool ObstacleSet::addPolygon(const std::vector<float> &xs,
+                             const std::vector<float> &ys) {
+  if (xs.size() < 3u) return false;
+
+  // monotone chain, collinear points are dropped
+  std::vector<std::uint32_t> ids(xs.size());
+  std::iota(ids.begin(), ids.end(), 0u);
+  std::sort(ids.begin(), ids.end(), [&](std::uint32_t a, std::uint32_t b) {
+    return xs[a] < xs[b] || (xs[a] == xs[b] && ys[a] < ys[b]);
+  });
+  auto cross = [&](std::uint32_t o, std::uint32_t a, std::uint32_t b) {
+    return (static_cast<double>(xs[a]) - xs[o]) * (ys[b] - ys[o]) -
+           (static_cast<double>(ys[a]) - ys[o]) * (xs[b] - xs[o]);
+  };
+  std::vector<std::uint32_t> hull(2u * ids.size());
+  std::size_t k = 0u;
+  for (std::size_t i = 0u; i < ids.size(); ++i) {
+    while (k >= 2u && cross(hull[k - 2u], hull[k - 1u], ids[i]) <= 0.0) --k;
+    hull[k++] = ids[i];
+  }
+  for (std::size_t i = ids.size() - 1u, lower = k + 1u; i-- > 0u;) {
+    while (k >= lower && cross(hull[k - 2u], hull[k - 1u], ids[i]) <= 0.0) {
+      --k;
+    }
+    hull[k++] = ids[i];
+  }
+  // the chain ends on its first point
+  if (k < 4u) return false;
+  hull.resize(k - 1u);
+
+  const std::uint32_t first = static_cast<std::uint32_t>(xs_.size());
+  for (const std::uint32_t id : hull) {
+    xs_.push_back(xs[id]);
+    ys_.push_back(ys[id]);
+  }
+  appendObstacle(first, false);
+  return true;
+}
+
+void ObstacleSet::appendObstacle(std::uint32_t first_vertex, bool is_box) {
+  Obstacle o{xs_[first_vertex],
+             ys_[first_vertex],
+             xs_[first_vertex],
+             ys_[first_vertex],
+             first_vertex,
+             static_cast<std::uint32_t>(xs_.size()) - first_vertex,
+             is_box};
+  for (std::uint32_t v = first_vertex; v < xs_.size(); ++v) {
+    o.min_x = std::min(o.min_x, xs_[v]);
+    o.min_y = std::min(o.min_y, ys_[v]);
+    o.max_x = std::max(o.max_x, xs_[v]);
+    o.max_y = std::max(o.max_y, ys_[v]);
+  }
+  obstacles_.push_back(o);
+}
+
+void ObstacleSet::remove(std::size_t i) {
+  // close the gap in the vertex array
+  const Obstacle removed = obstacles_[i];
+  xs_.erase(xs_.begin() + removed.first_vertex,
+            xs_.begin() + removed.first_vertex + removed.no_of_vertices);
+  ys_.erase(ys_.begin() + removed.first_vertex,
+            ys_.begin() + removed.first_vertex + removed.no_of_vertices);
+  for (Obstacle &o : obstacles_) {
+    if (o.first_vertex > removed.first_vertex) {
+      o.first_vertex -= removed.no_of_vertices;
+    }
+  }
+  obstacles_[i] = obstacles_.back();
+  obstacles_.pop_back();
+}
+
+void ObstacleSet::clear() {
+  obstacles_.clear();
+  xs_.clear();
+  ys_.clear();
+  nodes_.clear();
+  order_.clear();
+}
+
+void ObstacleSet::build() {
+  nodes_.clear();
+  order_.resize(obstacles_.size());
+  std::iota(order_.begin(), order_.end(), 0u);
+  if (obstacles_.empty()) return;
+  nodes_.reserve(2u * (obstacles_.size() / LEAF_SIZE + 1u));
+  nodes_.push_back({});
+  buildNode(0u, 0u, static_cast<std::uint32_t>(order_.size()));
+}
+
+void ObstacleSet::buildNode(std::uint32_t node, std::uint32_t begin,
+                            std::uint32_t end) {
+  Node n{obstacles_[order_[begin]].min_x, obstacles_[order_[begin]].min_y,
+         obstacles_[order_[begin]].max_x, obstacles_[order_[begin]].max_y,
+         begin, end - begin};
+  float c_min_x = n.min_x + n.max_x, c_max_x = c_min_x;
+  float c_min_y = n.min_y + n.max_y, c_max_y = c_min_y;
+  for (std::uint32_t i = begin; i < end; ++i) {
+    const Obstacle &o = obstacles_[order_[i]];
+    n.min_x = std::min(n.min_x, o.min_x);
+    n.min_y = std::min(n.min_y, o.min_y);
+    n.max_x = std::max(n.max_x, o.max_x);
+    n.max_y = std::max(n.max_y, o.max_y);
+    c_min_x = std::min(c_min_x, o.min_x + o.max_x);
+    c_max_x = std::max(c_max_x, o.min_x + o.max_x);
+    c_min_y = std::min(c_min_y, o.min_y + o.max_y);
+    c_max_y = std::max(c_max_y, o.min_y + o.max_y);
+  }
+  if (end - begin <= LEAF_SIZE) {
+    nodes_[node] = n;
+    return;
+  }
+
+  // median split of the box centres along their widest axis
+  const bool split_x = c_max_x - c_min_x >= c_max_y - c_min_y;
+  const std::uint32_t mid = begin + (end - begin) / 2u;
+  std::nth_element(order_.begin() + begin, order_.begin() + mid,
+                   order_.begin() + end,
+                   [this, split_x](std::uint32_t a, std::uint32_t b) {
+                     const Obstacle &oa = obstacles_[a], &ob = obstacles_[b];
+                     return split_x ? oa.min_x + oa.max_x < ob.min_x + ob.max_x
+                                    : oa.min_y + oa.max_y < ob.min_y + ob.max_y;
+                   });
+
+  const std::uint32_t left = static_cast<std::uint32_t>(nodes_.size());
+  nodes_.resize(nodes_.size() + 2u);
+  n.first = left;
+  n.count = 0u;
+  nodes_[node] = n;
+  buildNode(left, begin, mid);
+  buildNode(left + 1u, mid, end);
+}
+
+bool ObstacleSet::polygonContains(const Obstacle &o, double x,
+                                  double y) const {
+  const std::uint32_t last = o.first_vertex + o.no_of_vertices - 1u;
+  for (std::uint32_t v = o.first_vertex, u = last; v <= last; u = v++) {
+    const double ex = xs_[v] - xs_[u], ey = ys_[v] - ys_[u];
+    if (ex * (y - ys_[u]) - ey * (x - xs_[u]) < 0.0) return false;
+  }
+  return true;
+}
+
+bool ObstacleSet::polygonCrosses(const Obstacle &o, double x0, double y0,
+                                 double x1, double y1) const {
+  // Cyrus-Beck clipping of the segment against the edge half-planes
+  const double dx = x1 - x0, dy = y1 - y0;
+  double t_enter = 0.0, t_leave = 1.0;
+  const std::uint32_t last = o.first_vertex + o.no_of_vertices - 1u;
+  for (std::uint32_t v = o.first_vertex, u = last; v <= last; u = v++) {
+    // outward normal of the counter-clockwise edge from u to v
+    const double nx = ys_[v] - ys_[u], ny = xs_[u] - xs_[v];
+    const double num = nx * (xs_[u] - x0) + ny * (ys_[u] - y0);
+    const double den = nx * dx + ny * dy;
+    if (den == 0.0) {
+      if (num < 0.0) return false;
+    } else if (den < 0.0) {
+      t_enter = std::max(t_enter, num / den);
+    } else {
+      t_leave = std::min(t_leave, num / den);
+    }
+    if (t_enter > t_leave) return false;
+  }
+  return true;
+}
+
+std::size_t ObstacleSet::pick(double x, double y) const {
+  std::size_t hit = NONE;
+  if (nodes_.empty()) return hit;
+  std::uint32_t stack[MAX_DEPTH];
+  int top = 0;
+  stack[top++] = 0u;
+  while (top > 0) {
+    const Node &n = nodes_[stack[--top]];
+    if (!boxContains(n, x, y)) continue;
+    if (n.count == 0u) {
+      stack[top++] = n.first;
+      stack[top++] = n.first + 1u;
+      continue;
+    }
+    for (std::uint32_t i = n.first; i < n.first + n.count; ++i) {
+      const std::uint32_t id = order_[i];
+      if ((hit == NONE || id > hit) && boxContains(obstacles_[id], x, y) &&
+          (obstacles_[id].is_box || polygonContains(obstacles_[id], x, y))) {
+        hit = id;
+      }
+    }
+  }
+  return hit;
+}
+
+bool ObstacleSet::segmentCollides(double x0, double y0, double x1,
+                                  double y1) const {
+  if (nodes_.empty()) return false;
+  const double dx = x1 - x0, dy = y1 - y0;
+  const double inv_dx = dx != 0.0 ? 1.0 / dx : 0.0;
+  const double inv_dy = dy != 0.0 ? 1.0 / dy : 0.0;
+
+  std::uint32_t stack[MAX_DEPTH];
+  int top = 0;
+  stack[top++] = 0u;
+  while (top > 0) {
+    const Node &n = nodes_[stack[--top]];
+    if (!segmentHitsBox(n, x0, y0, dx, dy, inv_dx, inv_dy)) continue;
+    if (n.count == 0u) {
+      stack[top++] = n.first;
+      stack[top++] = n.first + 1u;
+      continue;
+    }
+    for (std::uint32_t i = n.first; i < n.first + n.count; ++i) {
+      const Obstacle &o = obstacles_[order_[i]];
+      if (!segmentHitsBox(o, x0, y0, dx, dy, inv_dx, inv_dy)) continue;
+      if (o.is_box || polygonCrosses(o, x0, y0, x1, y1)) return true;
+    }
+  }
+  return false;
+}
+
+std::size_t ObstacleSet::bytes() const {
+  return obstacles_.capacity() * sizeof(Obstacle) +
+         (xs_.capacity() + ys_.capacity()) * sizeof(float) +
+         nodes_.capacity() * sizeof(Node) +
+         order_.capacity() * sizeof(std::uint32_t);
+}
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
@@ -0,0 +1,326 @@
+#include "States/Algorithms/SamplingBased/PRM_STAR/PRM_STAR.h"
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <queue>
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+// Constructor
+PRM_STAR::PRM_STAR(std::shared_ptr<gui::LoggerPanel> logger_panel,
+                   std::shared_ptr<ThreadPool> thread_pool,
+                   const std::string &name)
+    : RRT(logger_panel, thread_pool, name),
+      roadmap_size_{0u},
+      is_roadmap_valid_{false} {
+  initParameters();
+  initialize();
+}
+
+// Destructor
+PRM_STAR::~PRM_STAR() {}
+
+void PRM_STAR::initParameters() {
+  // initialize default planner related params
+  // TODO: default values should be read from file
+  max_iterations_ = 1000;
+  range_ = 0.05;
+  goal_radius_ = 0.1;
+  rewire_factor_ = 1.1;
+  batch_size_ = 100;
+}
+
+void PRM_STAR::initialize() {
+  start_vertex_->x = 0.5;
+  start_vertex_->y = 0.1;
+  start_vertex_->parent = NO_VERTEX;
+
+  goal_vertex_->x = 0.5;
+  goal_vertex_->y = 0.9;
+  goal_vertex_->parent = NO_VERTEX;
+
+  // the roadmap outlives resets, initPlanner() decides whether to reuse it
+}
+
+PRM_STAR::RoadmapKey PRM_STAR::roadmapKey() const {
+  return RoadmapKey{obstacles_revision_, map_width_,     map_height_,
+                    max_iterations_,     rewire_factor_, nn_backend_};
+}
+
+// override initPlanner() function
+void PRM_STAR::initPlanner() {
+  if (is_roadmap_valid_ && roadmapKey() == roadmap_key_) {
+    // forget the last query, then replay the roadmap into the new trace
+    for (const std::uint32_t id : query_vertices_) vertices_.detach(id);
+    query_vertices_.clear();
+    vertices_.truncate(roadmap_size_);
+
+    for (std::uint32_t id = 0u; id < roadmap_size_; ++id) recordVertex(id);
+    for (std::uint32_t id = 0u; id < roadmap_size_; ++id) {
+      for (const std::uint32_t neighbour : adjacency_[id]) {
+        if (neighbour < id) recordEdge(id, neighbour);
+      }
+    }
+
+    curr_iter_no_.store(static_cast<unsigned int>(max_iterations_),
+                        std::memory_order_relaxed);
+    return;
+  }
+
+  // start a new roadmap
+  vertices_.clear();
+  vertices_.reserve(max_iterations_ + 2u);
+  roadmap_nn_ = makeNearestNeighbors(nn_backend_);
+  roadmap_nn_->reserve(max_iterations_);
+  adjacency_.clear();
+  no_of_edges_ = 0u;
+  roadmap_size_ = 0u;
+  query_vertices_.clear();
+  roadmap_key_ = roadmapKey();
+  is_roadmap_valid_ = false;
+}
+
+void PRM_STAR::renderParametersGui() {
+  gui::inputDouble("rewire_factor", &rewire_factor_, 1.0, 2.0, 0.01, 0.1,
+                   "Scales the connection radius of the roadmap", "%.2f");
+  gui::inputInt("batch_size", &batch_size_, 1, 100000, 10, 100,
+                "Number of samples added to the roadmap at once");
+}
+
+void PRM_STAR::renderStats() {
+  ImGui::Text("Roadmap: %zu vertices, %zu edges", vertices_.size(),
+              no_of_edges_.load());
+  if (is_solved_) {
+    if (path_cost_ < std::numeric_limits<double>::infinity()) {
+      ImGui::Text("Path cost: %.4f", path_cost_);
+    } else {
+      ImGui::Text("Path cost: no path");
+    }
+    ImGui::Text("Last query: %.3f ms", query_ms_);
+  }
+  SamplingBased::renderStats();
+}
+
+void PRM_STAR::updatePlanner(bool &solved, Vertex &start, Vertex &goal) {
+  if (!is_roadmap_valid_) {
+    // every call adds one batch of samples to the roadmap
+    const unsigned int iter_no = curr_iter_no_.load(std::memory_order_relaxed);
+    const unsigned int batch = static_cast<unsigned int>(std::min(
+        batch_size_, max_iterations_ - static_cast<int>(iter_no)));
+
+    if (batch > 0u) {
+      growRoadmap(batch);
+      curr_iter_no_.fetch_add(batch, std::memory_order_relaxed);
+      return;
+    }
+    is_roadmap_valid_ = true;
+  }
+
+  const auto t0 = std::chrono::steady_clock::now();
+  query(start, goal);
+  query_ms_ = std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - t0)
+                  .count();
+  solved = true;
+}
+
+void PRM_STAR::requery() {
+  if (!is_roadmap_valid_) return;
+  if (!(roadmapKey() == roadmap_key_)) {
+    logger_panel_->info(
+        "The roadmap is outdated, reset & run the planner to rebuild it.");
+    return;
+  }
+
+  const auto t0 = std::chrono::steady_clock::now();
+  const bool found = query(*start_vertex_, *goal_vertex_);
+  query_ms_ = std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - t0)
+                  .count();
+
+  char buf[128];
+  std::snprintf(buf, sizeof(buf), "%s on the roadmap in %.3f ms",
+                found ? "Path found" : "No path found", query_ms_);
+  logger_panel_->info(buf);
+}
+
+double PRM_STAR::connectionRadius() const {
+  // r = gamma * (log(n) / n)^(1/d), gamma > 2 * (1 + 1/d)^(1/d) *
+  // (free area / unit ball volume)^(1/d) with d = 2
+  const double n = std::max(static_cast<double>(roadmap_size_), 2.0);
+  const double gamma =
+      rewire_factor_ * 2.0 * std::sqrt((1.0 + 1.0 / 2.0) / M_PI);
+  return gamma * std::sqrt(std::log(n) / n);
+}
+
+void PRM_STAR::growRoadmap(unsigned int no_of_samples) {
+  const std::uint32_t first = static_cast<std::uint32_t>(vertices_.size());
+
+  // batched sampling, samples inside obstacles are dropped
+  for (unsigned int i = 0u; i < no_of_samples; ++i) {
+    Vertex v;
+    sample(v);
+    ++no_of_collision_checks_;
+    if (isCollision(v, v)) continue;
+    const std::uint32_t id = vertices_.add(v.x, v.y, NO_VERTEX, 0.0);
+    roadmap_nn_->add(id, v.x, v.y);
+    recordVertex(id);
+  }
+  const std::uint32_t last = static_cast<std::uint32_t>(vertices_.size());
+  roadmap_size_ = last;
+  adjacency_.resize(last);
+  batch_edges_.resize(last - first);
+
+  // radius queries & collision checks of the new vertices run in parallel,
+  // each task only writes the edge list of its own vertex
+  const double r = connectionRadius();
+  thread_pool_->parallelFor(
+      first, last,
+      [this, first, r](std::size_t i) {
+        thread_local std::vector<std::uint32_t> near_ids;
+        near_ids.clear();
+        const Vertex v = treeVertex(static_cast<std::uint32_t>(i));
+        roadmap_nn_->radius(v.x, v.y, r, near_ids);
+
+        std::vector<std::uint32_t> &edges = batch_edges_[i - first];
+        edges.clear();
+        std::size_t no_of_checks = 0u;
+        for (const std::uint32_t j : near_ids) {
+          // edges between two new vertices are checked from the later one
+          if (j >= i) continue;
+          ++no_of_checks;
+          if (!isCollision(v, treeVertex(j))) edges.push_back(j);
+        }
+        no_of_collision_checks_ += no_of_checks;
+      },
+      16u);
+
+  // merge the edges into the roadmap
+  for (std::uint32_t i = first; i < last; ++i) {
+    for (const std::uint32_t j : batch_edges_[i - first]) {
+      adjacency_[i].push_back(j);
+      adjacency_[j].push_back(i);
+      recordEdge(i, j);
+    }
+    no_of_edges_ += batch_edges_[i - first].size();
+  }
+}
+
+bool PRM_STAR::query(const Vertex &start, Vertex &goal) {
+  // remove the previous query from the tree, its ids are taken again
+  for (const std::uint32_t id : query_vertices_) {
+    vertices_.detach(id);
+    recordPrune(id);
+  }
+  query_vertices_.clear();
+  vertices_.truncate(roadmap_size_);
+  goal.parent = NO_VERTEX;
+  path_cost_ = std::numeric_limits<double>::infinity();
+
+  const std::uint32_t start_id =
+      vertices_.add(start.x, start.y, NO_VERTEX, 0.0);
+  const std::uint32_t goal_id = vertices_.add(goal.x, goal.y, NO_VERTEX, 0.0);
+  recordVertex(start_id);
+  recordVertex(goal_id);
+  query_vertices_.push_back(start_id);
+  query_vertices_.push_back(goal_id);
+
+  const std::uint32_t n = roadmap_size_;
+  const double r = connectionRadius();
+  std::vector<std::uint32_t> &near_ids = worker().near_ids;
+  g_costs_.assign(n, std::numeric_limits<double>::infinity());
+  came_from_.assign(n, NO_VERTEX);
+  goal_costs_.assign(n, std::numeric_limits<double>::infinity());
+
+  // best path so far ends with an edge from best_last into the goal,
+  // NO_VERTEX stands for the direct edge from the start
+  double best_cost = std::numeric_limits<double>::infinity();
+  std::uint32_t best_last = NO_VERTEX;
+  if (distance(start, goal) < r) {
+    ++no_of_collision_checks_;
+    if (!isCollision(start, goal)) best_cost = distance(start, goal);
+  }
+
+  // connect the goal to the roadmap
+  near_ids.clear();
+  roadmap_nn_->radius(goal.x, goal.y, r, near_ids);
+  for (const std::uint32_t id : near_ids) {
+    const Vertex v = treeVertex(id);
+    if (!isCollision(goal, v)) goal_costs_[id] = distance(goal, v);
+  }
+  no_of_collision_checks_ += near_ids.size();
+
+  // A* from the start, the straight-line distance to the goal is admissible
+  auto heuristic = [this, &goal](std::uint32_t id) {
+    return distance(treeVertex(id), goal);
+  };
+  using QueueEntry = std::pair<double, std::uint32_t>;
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>,
+                      std::greater<QueueEntry>>
+      open;
+
+  near_ids.clear();
+  roadmap_nn_->radius(start.x, start.y, r, near_ids);
+  for (const std::uint32_t id : near_ids) {
+    const Vertex v = treeVertex(id);
+    ++no_of_collision_checks_;
+    if (isCollision(start, v)) continue;
+    g_costs_[id] = distance(start, v);
+    came_from_[id] = start_id;
+    open.push({g_costs_[id] + heuristic(id), id});
+  }
+
+  while (!open.empty()) {
+    const QueueEntry top = open.top();
+    open.pop();
+    if (top.first >= best_cost) break;
+
+    const std::uint32_t id = top.second;
+    const double g = g_costs_[id];
+    // skip entries superseded by a cheaper path
+    if (top.first > g + heuristic(id)) continue;
+
+    if (g + goal_costs_[id] < best_cost) {
+      best_cost = g + goal_costs_[id];
+      best_last = id;
+    }
+
+    const Vertex v = treeVertex(id);
+    for (const std::uint32_t neighbour : adjacency_[id]) {
+      const double g_new = g + distance(v, treeVertex(neighbour));
+      if (g_new < g_costs_[neighbour]) {
+        g_costs_[neighbour] = g_new;
+        came_from_[neighbour] = id;
+        open.push({g_new + heuristic(neighbour), neighbour});
+      }
+    }
+  }
+
+  path_cost_ = best_cost;
+  if (best_cost == std::numeric_limits<double>::infinity()) return false;
+
+  // collect the path backward, then hang it below the start vertex
+  const std::size_t path_begin = query_vertices_.size();
+  for (std::uint32_t id = best_last; id != NO_VERTEX && id != start_id;
+       id = came_from_[id]) {
+    query_vertices_.push_back(id);
+  }
+  std::uint32_t parent = start_id;
+  for (std::size_t k = query_vertices_.size(); k > path_begin; --k) {
+    const std::uint32_t id = query_vertices_[k - 1u];
+    vertices_.reparent(id, parent, g_costs_[id]);
+    recordRewire(id);
+    parent = id;
+  }
+  vertices_.reparent(goal_id, parent, best_cost);
+  recordRewire(goal_id);
+
+  recordSolution(goal_id);
+  goal.parent = goal_id;
+  return true;
+}
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
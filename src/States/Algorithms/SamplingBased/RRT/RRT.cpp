@@ -1,12 +1,14 @@
 #include "States/Algorithms/SamplingBased/RRT/RRT.h"
 
+#include <algorithm>
+
 namespace path_finding_visualizer {
 namespace sampling_based {
 
 // Constructor
 RRT::RRT(std::shared_ptr<gui::LoggerPanel> logger_panel,
-         const std::string &name)
-    : SamplingBased(logger_panel, name) {
+         std::shared_ptr<ThreadPool> thread_pool, const std::string &name)
+    : SamplingBased(logger_panel, thread_pool, name) {
   initParameters();
   initialize();
 }
@@ -18,7 +20,6 @@ void RRT::initParameters() {
   // initialize default planner related params
   // TODO: default values should be read from file
   max_iterations_ = 1000;
-  interpolation_dist_ = 0.005;
   range_ = 0.05;
   goal_radius_ = 0.1;
 }
@@ -26,63 +27,97 @@ void RRT::initParameters() {
 void RRT::initialize() {
   start_vertex_->x = 0.5;
   start_vertex_->y = 0.1;
-  start_vertex_->parent = nullptr;
+  start_vertex_->parent = NO_VERTEX;
 
   goal_vertex_->x = 0.5;
   goal_vertex_->y = 0.9;
-  goal_vertex_->parent = nullptr;
+  goal_vertex_->parent = NO_VERTEX;
 
   vertices_.clear();
-  edges_.clear();
 }
 
 // override initPlanner() function
 void RRT::initPlanner() {
-  // clear all the vertices & edges
+  // clear all the vertices, every iteration adds at most one, so workers
+  // never outgrow the reserved arena
   vertices_.clear();
-  edges_.clear();
+  vertices_.reserve(max_iterations_ + 1u);
+  nn_->reserve(max_iterations_ + 1u);
 
   // add start vertex to vertices
-  vertices_.emplace_back(start_vertex_);
+  const std::uint32_t start_id =
+      vertices_.add(start_vertex_->x, start_vertex_->y, NO_VERTEX, 0.0);
+  indexVertex(start_id);
+  recordVertex(start_id);
 }
 
-void RRT::renderPlannerData(sf::RenderTexture &render_texture) {
-  // render edges
-  std::unique_lock<std::mutex> lck(mutex_);
-  for (const auto &edge : edges_) {
-    double p1_y = utils::map(edge.first->y, 0.0, 1.0, init_grid_xy_.x,
-                             init_grid_xy_.x + map_width_);
-    double p1_x = utils::map(edge.first->x, 0.0, 1.0, init_grid_xy_.y,
-                             init_grid_xy_.y + map_height_);
-    double p2_y = utils::map(edge.second->y, 0.0, 1.0, init_grid_xy_.x,
-                             init_grid_xy_.x + map_width_);
-    double p2_x = utils::map(edge.second->x, 0.0, 1.0, init_grid_xy_.y,
-                             init_grid_xy_.y + map_height_);
+void RRT::reconnectGoal(Vertex &goal) {
+  goal.parent = NO_VERTEX;
 
-    sf::Vertex line[] = {sf::Vertex(sf::Vector2f(p1_y, p1_x), EDGE_COL),
-                         sf::Vertex(sf::Vector2f(p2_y, p2_x), EDGE_COL)};
+  // vertices the planner could have reached the goal from
+  std::vector<std::uint32_t> &near_ids = worker().near_ids;
+  near_ids.clear();
+  {
+    std::shared_lock<std::shared_mutex> lock(nn_mutex_);
+    nn_->radius(goal.x, goal.y, std::max(range_, goal_radius_), near_ids);
+  }
 
-    render_texture.draw(line, 2, sf::Lines);
+  // candidate parents by the path cost they would give, cheapest first
+  std::vector<std::pair<double, std::uint32_t>> candidates;
+  candidates.reserve(near_ids.size());
+  for (const std::uint32_t id : near_ids) {
+    candidates.push_back({cost(id) + distance(treeVertex(id), goal), id});
   }
-  lck.unlock();
+  std::sort(candidates.begin(), candidates.end());
+
+  for (const auto &candidate : candidates) {
+    ++no_of_collision_checks_;
+    if (isCollision(treeVertex(candidate.second), goal)) continue;
+    goal.parent = candidate.second;
+    break;
+  }
+  recordSolution(goal.parent);
+}
+
+void RRT::resumePlanner() {
+  vertices_.reserve(iteration_limit_ + 1u);
+  nn_->reserve(iteration_limit_ + 1u);
+}
+
+void RRT::renderPlannerData(sf::RenderTexture &render_texture) {
+  // maps a normalized vertex position into the planning scene
+  auto to_scene = [this](const sf::Vector2f &v) {
+    return sf::Vector2f(utils::map(v.y, 0.0, 1.0, init_grid_xy_.x,
+                                   init_grid_xy_.x + map_width_),
+                        utils::map(v.x, 0.0, 1.0, init_grid_xy_.y,
+                                   init_grid_xy_.y + map_height_));
+  };
+
+  // render edges of the replayed tree inside the view
+  renderReplayTree(render_texture);
 
   // render path if available
-  if (goal_vertex_->parent) {
-    std::shared_ptr<Vertex> current = goal_vertex_;
-    while (current->parent && current != start_vertex_) {
-      double p1_y = utils::map(current->y, 0.0, 1.0, init_grid_xy_.x,
-                               init_grid_xy_.x + map_width_);
-      double p1_x = utils::map(current->x, 0.0, 1.0, init_grid_xy_.y,
-                               init_grid_xy_.y + map_height_);
-      double p2_y = utils::map(current->parent->y, 0.0, 1.0, init_grid_xy_.x,
-                               init_grid_xy_.x + map_width_);
-      double p2_x = utils::map(current->parent->x, 0.0, 1.0, init_grid_xy_.y,
-                               init_grid_xy_.y + map_height_);
-
-      utils::sfPath path(sf::Vector2f(p1_y, p1_x), sf::Vector2f(p2_y, p2_x),
-                         4.f, PATH_COL);
+  if (replay_solution_ != Trace::NO_PARENT) {
+    sf::Vector2f p1 = to_scene(sf::Vector2f(goal_vertex_->x, goal_vertex_->y));
+    std::uint32_t current = replay_solution_;
+    while (current != Trace::NO_PARENT) {
+      const sf::Vector2f p2 = to_scene(replay_vertices_[current]);
+      utils::sfPath path(p1, p2, 4.f, PATH_COL);
+      render_texture.draw(path);
+      p1 = p2;
+      current = replay_parents_[current];
+    }
+  }
+
+  // smoothed path once the replay has caught up with the solver
+  if (is_solved_ && replay_cursor_ == trace_.size()) {
+    for (std::size_t i = 1u; i < smoothed_path_.size(); ++i) {
+      const PathPoint &a = smoothed_path_[i - 1u], &b = smoothed_path_[i];
+      if (a.x == b.x && a.y == b.y) continue;
+      utils::sfPath path(to_scene(sf::Vector2f(a.x, a.y)),
+                         to_scene(sf::Vector2f(b.x, b.y)), 3.f,
+                         SMOOTH_PATH_COL);
       render_texture.draw(path);
-      current = current->parent;
     }
   }
 
@@ -116,132 +151,90 @@ void RRT::renderParametersGui() {
 }
 
 void RRT::updatePlanner(bool &solved, Vertex &start, Vertex &goal) {
-  std::unique_lock<std::mutex> iter_no_lck(iter_no_mutex_);
-  bool running = (curr_iter_no_ < max_iterations_);
-  iter_no_lck.unlock();
-
-  if (running) {
-    std::shared_ptr<Vertex> x_rand = std::make_shared<Vertex>();
-    std::shared_ptr<Vertex> x_nearest = std::make_shared<Vertex>();
-    std::shared_ptr<Vertex> x_new = std::make_shared<Vertex>();
-
-    sample(x_rand);
-    nearest(x_rand, x_nearest);
-
-    // find the distance between x_rand and x_nearest
-    double d = distance(x_rand, x_nearest);
-
-    // if this distance d > max_distance_, we need to find nearest state in
-    // the direction of x_rand
-    if (d > range_) {
-      interpolate(x_nearest, x_rand, range_ / d, x_new);
-    } else {
-      x_new->x = x_rand->x;
-      x_new->y = x_rand->y;
-    }
-
-    if (!isCollision(x_nearest, x_new)) {
-      x_new->parent = x_nearest;
+  unsigned int iter_no;
+  if (!claimIteration(iter_no)) {
+    std::cout << "Iterations number reach max limit. Planning stopped." << '\n';
+    solved = true;
+    return;
+  }
 
-      std::unique_lock<std::mutex> lck(mutex_);
-      vertices_.emplace_back(x_new);
-      edges_.emplace_back(x_nearest, x_new);
-      lck.unlock();
+  // scratch samples stay on the stack
+  Vertex x_rand, x_new;
+  sample(x_rand);
+  const std::uint32_t nearest_id = nearest(x_rand);
+  const Vertex x_nearest = treeVertex(nearest_id);
 
-      if (inGoalRegion(x_new)) {
-        goal.parent = std::move(x_new);
-        solved = true;
-      }
-    }
+  // find the distance between x_rand and x_nearest
+  double d = distance(x_rand, x_nearest);
 
-    iter_no_lck.lock();
-    curr_iter_no_++;
-    iter_no_lck.unlock();
+  // if this distance d > max_distance_, we need to find nearest state in
+  // the direction of x_rand
+  if (d > range_) {
+    interpolate(x_nearest, x_rand, range_ / d, x_new);
   } else {
-    std::cout << "Iterations number reach max limit. Planning stopped." << '\n';
-    solved = true;
+    x_new.x = x_rand.x;
+    x_new.y = x_rand.y;
   }
-}
 
-void RRT::sample(const std::shared_ptr<Vertex> &v) {
-  std::uniform_real_distribution<> dis(0, 1);
-  v->x = dis(rn_gen_);
-  v->y = dis(rn_gen_);
-}
-
-bool RRT::isCollision(const std::shared_ptr<const Vertex> &from_v,
-                      const std::shared_ptr<const Vertex> &to_v) {
-  // check collison from from_v to to_v
-  // interpolate vertices between from_v and to_v
-  // assume from_v is collision free
-
-  const double max_dist = distance(from_v, to_v);
-
-  double d = interpolation_dist_;
-  while (d < max_dist) {
-    std::shared_ptr<Vertex> temp_v = std::make_shared<Vertex>();
-    interpolate(from_v, to_v, d / max_dist, temp_v);
-
-    double pixel_y = utils::map(temp_v->y, 0.0, 1.0, 0.0, map_width_);
-    double pixel_x = utils::map(temp_v->x, 0.0, 1.0, 0.0, map_height_);
-    for (const auto &obst : obstacles_) {
-      if (obst->getGlobalBounds().contains(sf::Vector2f(pixel_y, pixel_x))) {
-        return true;
-      }
+  ++no_of_collision_checks_;
+  if (!isCollision(x_nearest, x_new)) {
+    // costs never change in RRT, so workers append without a tree lock
+    const std::uint32_t new_id =
+        vertices_.addReserved(x_new.x, x_new.y, nearest_id,
+                              cost(nearest_id) + distance(x_nearest, x_new));
+    // recorded before other workers can find it & record its children
+    recordVertex(new_id);
+    indexVertex(new_id);
+
+    if (inGoalRegion(x_new)) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      recordSolution(new_id);
+      goal.parent = new_id;
+      solved = true;
     }
-    d += interpolation_dist_;
   }
+}
 
-  // now we check the destination vertex to_v
-  double pixel_y = utils::map(to_v->y, 0.0, 1.0, 0.0, map_width_);
-  double pixel_x = utils::map(to_v->x, 0.0, 1.0, 0.0, map_height_);
-  for (const auto &obst : obstacles_) {
-    if (obst->getGlobalBounds().contains(sf::Vector2f(pixel_y, pixel_x))) {
-      return true;
+void RRT::sample(Vertex &v) {
+  if (goal_bias_ > 0.0) {
+    std::uniform_real_distribution<> dis(0, 1);
+    if (dis(worker().rn_gen) < goal_bias_) {
+      v.x = goal_vertex_->x;
+      v.y = goal_vertex_->y;
+      return;
     }
   }
-
-  return false;
+  nextSample(v.x, v.y);
 }
 
-void RRT::interpolate(const std::shared_ptr<const Vertex> &from_v,
-                      const std::shared_ptr<const Vertex> &to_v, const double t,
-                      const std::shared_ptr<Vertex> &v) {
-  v->x = from_v->x + (to_v->x - from_v->x) * t;
-  v->y = from_v->y + (to_v->y - from_v->y) * t;
+bool RRT::isCollision(const Vertex &from_v, const Vertex &to_v) const {
+  // exact test against the obstacles whose boxes the segment touches
+  // vertex y maps to the horizontal axis & vertex x to the vertical axis
+  return obstacles_.segmentCollides(from_v.y * map_width_,
+                                    from_v.x * map_height_,
+                                    to_v.y * map_width_, to_v.x * map_height_);
 }
 
-void RRT::nearest(const std::shared_ptr<const Vertex> &x_rand,
-                  std::shared_ptr<Vertex> &x_near) {
-  double minDist = std::numeric_limits<double>::infinity();
-
-  for (const auto &v : vertices_) {
-    double dist = distance(v, x_rand);
-    if (dist < minDist) {
-      minDist = dist;
-      x_near = v;
-    }
-  }
+void RRT::interpolate(const Vertex &from_v, const Vertex &to_v, const double t,
+                      Vertex &v) const {
+  v.x = from_v.x + (to_v.x - from_v.x) * t;
+  v.y = from_v.y + (to_v.y - from_v.y) * t;
 }
 
-double RRT::cost(std::shared_ptr<Vertex> v) {
-  std::shared_ptr<Vertex> curr_p = std::move(v);
-  double cost = 0.0;
-  while (curr_p->parent) {
-    cost += distance(curr_p, curr_p->parent);
-    curr_p = curr_p->parent;
-  }
-  return cost;
+std::uint32_t RRT::nearest(const Vertex &x_rand) {
+  std::shared_lock<std::shared_mutex> lock(nn_mutex_);
+  return nn_->nearest(x_rand.x, x_rand.y);
 }
 
-double RRT::distance(const std::shared_ptr<const Vertex> &v1,
-                     const std::shared_ptr<const Vertex> &v2) {
-  return std::sqrt((v1->x - v2->x) * (v1->x - v2->x) +
-                   (v1->y - v2->y) * (v1->y - v2->y));
+double RRT::cost(std::uint32_t id) const { return vertices_.cost[id]; }
+
+double RRT::distance(const Vertex &v1, const Vertex &v2) const {
+  return std::sqrt((v1.x - v2.x) * (v1.x - v2.x) +
+                   (v1.y - v2.y) * (v1.y - v2.y));
 }
 
-bool RRT::inGoalRegion(const std::shared_ptr<const Vertex> &v) {
-  if (distance(v, goal_vertex_) <= goal_radius_) return true;
+bool RRT::inGoalRegion(const Vertex &v) const {
+  if (distance(v, *goal_vertex_) <= goal_radius_) return true;
   return false;
 }
 
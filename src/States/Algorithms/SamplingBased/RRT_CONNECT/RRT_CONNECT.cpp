@@ -0,0 +1,138 @@
+#include "States/Algorithms/SamplingBased/RRT_CONNECT/RRT_CONNECT.h"
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+// Constructor
+RRT_CONNECT::RRT_CONNECT(std::shared_ptr<gui::LoggerPanel> logger_panel,
+                         std::shared_ptr<ThreadPool> thread_pool,
+                         const std::string &name)
+    : RRT(logger_panel, thread_pool, name),
+      goal_root_{NO_VERTEX},
+      current_tree_{START_TREE} {
+  initParameters();
+  initialize();
+}
+
+// Destructor
+RRT_CONNECT::~RRT_CONNECT() {}
+
+void RRT_CONNECT::initParameters() {
+  // initialize default planner related params
+  // TODO: default values should be read from file
+  max_iterations_ = 1000;
+  range_ = 0.05;
+  goal_radius_ = 0.1;
+}
+
+// override initPlanner() function
+void RRT_CONNECT::initPlanner() {
+  // both trees share vertices_, a connect step can add many vertices
+  vertices_.clear();
+  vertices_.reserve(2u * (max_iterations_ + 1u));
+  goal_nn_ = makeNearestNeighbors(nn_backend_);
+  nn_->reserve(max_iterations_ + 1u);
+  goal_nn_->reserve(max_iterations_ + 1u);
+
+  // add the roots of both trees
+  const std::uint32_t start_root =
+      vertices_.add(start_vertex_->x, start_vertex_->y, NO_VERTEX, 0.0);
+  nn_->add(start_root, start_vertex_->x, start_vertex_->y);
+  recordVertex(start_root);
+
+  goal_root_ = vertices_.add(goal_vertex_->x, goal_vertex_->y, NO_VERTEX, 0.0);
+  goal_nn_->add(goal_root_, goal_vertex_->x, goal_vertex_->y);
+  recordVertex(goal_root_);
+
+  current_tree_ = START_TREE;
+}
+
+void RRT_CONNECT::renderParametersGui() {
+  gui::inputDouble("range", &range_, 0.01, 1000.0, 0.01, 1.0,
+                   "Maximum distance allowed between two vertices", "%.3f");
+}
+
+void RRT_CONNECT::updatePlanner(bool &solved, Vertex &start, Vertex &goal) {
+  unsigned int iter_no;
+  if (!claimIteration(iter_no)) {
+    solved = true;
+    return;
+  }
+
+  Vertex x_rand;
+  sample(x_rand);
+
+  // extend one tree toward the sample, then greedily connect the other tree
+  // to the new vertex
+  const int other_tree = current_tree_ == START_TREE ? GOAL_TREE : START_TREE;
+  std::uint32_t new_id;
+  if (extend(current_tree_, x_rand, new_id) != TRAPPED) {
+    const Vertex x_target = treeVertex(new_id);
+    std::uint32_t other_id;
+    EXTEND_STATUS status;
+    do {
+      status = extend(other_tree, x_target, other_id);
+    } while (status == ADVANCED);
+
+    if (status == REACHED) {
+      if (current_tree_ == START_TREE) {
+        joinTrees(new_id, other_id, goal);
+      } else {
+        joinTrees(other_id, new_id, goal);
+      }
+      solved = true;
+    }
+  }
+
+  // swap the roles of the trees
+  current_tree_ = other_tree;
+}
+
+RRT_CONNECT::EXTEND_STATUS RRT_CONNECT::extend(int tree, const Vertex &target,
+                                               std::uint32_t &new_id) {
+  NearestNeighbors &index = tree == START_TREE ? *nn_ : *goal_nn_;
+  const std::uint32_t nearest_id = index.nearest(target.x, target.y);
+  const Vertex x_nearest = treeVertex(nearest_id);
+
+  // steer toward the target by at most range_
+  Vertex x_new;
+  const double d = distance(x_nearest, target);
+  if (d > range_) {
+    interpolate(x_nearest, target, range_ / d, x_new);
+  } else {
+    x_new.x = target.x;
+    x_new.y = target.y;
+  }
+
+  ++no_of_collision_checks_;
+  if (isCollision(x_nearest, x_new)) return TRAPPED;
+
+  new_id = vertices_.add(x_new.x, x_new.y, nearest_id,
+                         cost(nearest_id) + distance(x_nearest, x_new));
+  index.add(new_id, x_new.x, x_new.y);
+  recordVertex(new_id);
+  return d > range_ ? ADVANCED : REACHED;
+}
+
+void RRT_CONNECT::joinTrees(std::uint32_t start_id, std::uint32_t goal_id,
+                            Vertex &goal) {
+  // walk up the goal tree, every vertex becomes the child of the previous one
+  std::uint32_t parent = start_id;
+  std::uint32_t current = goal_id;
+  while (current != NO_VERTEX) {
+    const std::uint32_t next = vertices_.parent[current];
+    vertices_.reparent(
+        current, parent,
+        cost(parent) + distance(treeVertex(parent), treeVertex(current)));
+    recordRewire(current);
+    parent = current;
+    current = next;
+  }
+
+  // the goal root now ends the path from the start
+  recordSolution(goal_root_);
+  goal.parent = goal_root_;
+}
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
@@ -1,12 +1,15 @@
 #include "States/Algorithms/SamplingBased/RRT_STAR/RRT_STAR.h"
 
+#include <algorithm>
+
 namespace path_finding_visualizer {
 namespace sampling_based {
 
 // Constructor
 RRT_STAR::RRT_STAR(std::shared_ptr<gui::LoggerPanel> logger_panel,
+                   std::shared_ptr<ThreadPool> thread_pool,
                    const std::string &name)
-    : RRT(logger_panel, name) {
+    : RRT(logger_panel, thread_pool, name), lazy_collision_checking_{false} {
   initParameters();
   initialize();
 }
@@ -18,7 +21,6 @@ void RRT_STAR::initParameters() {
   // initialize default planner related params
   // TODO: default values should be read from file
   max_iterations_ = 2500;
-  interpolation_dist_ = 0.005;
   range_ = 0.05;
   goal_radius_ = 0.1;
   rewire_factor_ = 1.1;
@@ -28,14 +30,13 @@ void RRT_STAR::initParameters() {
 void RRT_STAR::initialize() {
   start_vertex_->x = 0.5;
   start_vertex_->y = 0.1;
-  start_vertex_->parent = nullptr;
+  start_vertex_->parent = NO_VERTEX;
 
   goal_vertex_->x = 0.5;
   goal_vertex_->y = 0.9;
-  goal_vertex_->parent = nullptr;
+  goal_vertex_->parent = NO_VERTEX;
 
   vertices_.clear();
-  edges_.clear();
   x_soln_.clear();
 
   // update rewiring lower bounds
@@ -46,12 +47,43 @@ void RRT_STAR::initialize() {
 
 // override initPlanner() function
 void RRT_STAR::initPlanner() {
-  // clear all the vertices & edges
-  vertices_.clear();
-  edges_.clear();
+  RRT::initPlanner();
   x_soln_.clear();
-  // add start point to vertices
-  vertices_.emplace_back(start_vertex_);
+  is_edge_checked_.assign(max_iterations_ + 1u, 0u);
+  is_pruned_.assign(max_iterations_ + 1u, 0u);
+  no_of_repairs_ = 0u;
+}
+
+void RRT_STAR::reconnectGoal(Vertex &goal) {
+  std::vector<std::uint32_t> &near_ids = worker().near_ids;
+  near_ids.clear();
+  {
+    std::shared_lock<std::shared_mutex> lock(nn_mutex_);
+    nn_->radius(goal.x, goal.y, goal_radius_, near_ids);
+  }
+  x_soln_.clear();
+  for (const std::uint32_t id : near_ids) {
+    if (!is_pruned_[id]) x_soln_.push_back(id);
+  }
+
+  if (x_soln_.empty()) {
+    // lazy mode checks the edges of the new path, repairs change the costs
+    do {
+      RRT::reconnectGoal(goal);
+    } while (lazy_collision_checking_ && goal.parent != NO_VERTEX &&
+             !validatePath(goal.parent));
+    return;
+  }
+  // the old parent may be cheapest again, the trace still gets the solution
+  goal.parent = NO_VERTEX;
+  updateGoal(goal);
+  if (goal.parent == NO_VERTEX) recordSolution(NO_VERTEX);
+}
+
+void RRT_STAR::resumePlanner() {
+  RRT::resumePlanner();
+  is_edge_checked_.resize(iteration_limit_ + 1u, 0u);
+  is_pruned_.resize(iteration_limit_ + 1u, 0u);
 }
 
 void RRT_STAR::renderParametersGui() {
@@ -61,122 +93,262 @@ void RRT_STAR::renderParametersGui() {
                    "Rewiring factor", "%.2f");
   gui::inputDouble("goal_radius", &goal_radius_, 0.01, 1000.0, 0.01, 1.0,
                    "Distance between vertex and goal to stop planning", "%.3f");
+  gui::checkbox("lazy_collision_checking", &lazy_collision_checking_,
+                "Grow the tree with vertex checks only, edges are checked "
+                "once they are on the best path");
+}
+
+void RRT_STAR::renderStats() {
+  if (lazy_collision_checking_) {
+    ImGui::Text("Repaired edges: %zu", no_of_repairs_.load());
+  }
+  SamplingBased::renderStats();
 }
 
 void RRT_STAR::updatePlanner(bool &solved, Vertex &start, Vertex &goal) {
-  std::unique_lock<std::mutex> iter_no_lck(iter_no_mutex_);
-  bool running = (curr_iter_no_ < max_iterations_);
-  iter_no_lck.unlock();
-
-  if (running) {
-    std::shared_ptr<Vertex> x_rand = std::make_shared<Vertex>();
-    std::shared_ptr<Vertex> x_nearest = std::make_shared<Vertex>();
-    std::shared_ptr<Vertex> x_new = std::make_shared<Vertex>();
-
-    sample(x_rand);
-    nearest(x_rand, x_nearest);
-
-    // find the distance between x_rand and x_nearest
-    double d = distance(x_rand, x_nearest);
-
-    // if this distance d > delta_q, we need to find nearest state in the
-    // direction of x_rand
-    if (d > range_) {
-      interpolate(x_nearest, x_rand, range_ / d, x_new);
-    } else {
-      x_new->x = x_rand->x;
-      x_new->y = x_rand->y;
+  unsigned int iter_no;
+  if (!claimIteration(iter_no)) {
+    // the final path must not keep unchecked edges
+    updateGoal(goal);
+    std::cout << "Iterations number reach max limit. Planning stopped." << '\n';
+    solved = true;
+    return;
+  }
+
+  const bool lazy = lazy_collision_checking_;
+  std::size_t no_of_checks = 0u;
+
+  // scratch samples stay on the stack
+  Vertex x_rand, x_new;
+  sample(x_rand);
+  const std::uint32_t nearest_id = nearest(x_rand);
+  const Vertex x_nearest = treeVertex(nearest_id);
+
+  // find the distance between x_rand and x_nearest
+  double d = distance(x_rand, x_nearest);
+
+  // if this distance d > delta_q, we need to find nearest state in the
+  // direction of x_rand
+  if (d > range_) {
+    interpolate(x_nearest, x_rand, range_ / d, x_new);
+  } else {
+    x_new.x = x_rand.x;
+    x_new.y = x_rand.y;
+  }
+
+  // lazy mode only checks that the new vertex itself is valid
+  ++no_of_checks;
+  const bool is_valid = lazy ? !isCollision(x_new, x_new)
+                             : !isCollision(x_nearest, x_new);
+  if (is_valid) {
+    WorkerState &w = worker();
+
+    // find all the nearest neighbours inside radius
+    near(x_new, w.near_ids);
+    const std::size_t no_of_near = w.near_ids.size();
+
+    // snapshot of the costs, other workers may rewire them meanwhile
+    std::shared_lock<std::shared_mutex> read_lck(tree_mutex_);
+    double c_min = cost(nearest_id) + distance(x_nearest, x_new);
+    w.near_costs.resize(no_of_near);
+    for (std::size_t k = 0u; k < no_of_near; ++k) {
+      w.near_costs[k] = cost(w.near_ids[k]);
     }
+    read_lck.unlock();
 
-    if (!isCollision(x_nearest, x_new)) {
-      // find all the nearest neighbours inside radius
-      std::vector<std::shared_ptr<Vertex>> X_near;
-      near(x_new, X_near);
-
-      std::unique_lock<std::mutex> lck(mutex_);
-      vertices_.emplace_back(x_new);
-      lck.unlock();
-
-      // choose parent
-      std::shared_ptr<Vertex> x_min = x_nearest;
-      for (const auto &x_near : X_near) {
-        double c_new = cost(x_near) + distance(x_near, x_new);
-        if (c_new < cost(x_min) + distance(x_min, x_new)) {
-          if (!isCollision(x_near, x_new)) {
-            x_min = x_near;
-          }
+    // collision check the candidate parents & rewires without the lock, lazy
+    // mode takes every edge as free until it is on the best path
+    w.near_flags.assign(no_of_near, lazy ? FREE : UNCHECKED);
+    if (!lazy) {
+      for (std::size_t k = 0u; k < no_of_near; ++k) {
+        const Vertex x_near = treeVertex(w.near_ids[k]);
+        double c_new = w.near_costs[k] + distance(x_near, x_new);
+        if (c_new < c_min) {
+          ++no_of_checks;
+          w.near_flags[k] = isCollision(x_near, x_new) ? BLOCKED : FREE;
+          if (w.near_flags[k] == FREE) c_min = c_new;
         }
       }
-      x_new->parent = x_min;
-
-      lck.lock();
-      edges_.emplace_back(x_new->parent, x_new);
-      lck.unlock();
-
-      // rewiring
-      for (const auto &x_near : X_near) {
-        double c_near = cost(x_new) + distance(x_new, x_near);
-        if (c_near < cost(x_near)) {
-          if (!isCollision(x_near, x_new)) {
-            lck.lock();
-            edges_.erase(std::remove(edges_.begin(), edges_.end(),
-                                     std::make_pair(x_near->parent, x_near)),
-                         edges_.end());
-            x_near->parent = x_new;
-            edges_.emplace_back(x_new, x_near);
-            lck.unlock();
-          }
+      for (std::size_t k = 0u; k < no_of_near; ++k) {
+        if (w.near_flags[k] != UNCHECKED) continue;
+        const Vertex x_near = treeVertex(w.near_ids[k]);
+        if (c_min + distance(x_new, x_near) < w.near_costs[k]) {
+          ++no_of_checks;
+          w.near_flags[k] = isCollision(x_near, x_new) ? BLOCKED : FREE;
         }
       }
+    }
 
-      // add into x_soln if the vertex is within the goal radius
-      if (inGoalRegion(x_new)) {
-        x_soln_.emplace_back(x_new);
+    // choose parent & rewire on the current costs, only through edges
+    // known to be collision free
+    std::unique_lock<std::shared_mutex> write_lck(tree_mutex_);
+    std::uint32_t min_id = nearest_id;
+    c_min = cost(nearest_id) + distance(x_nearest, x_new);
+    for (std::size_t k = 0u; k < no_of_near; ++k) {
+      if (w.near_flags[k] != FREE) continue;
+      const std::uint32_t near_id = w.near_ids[k];
+      double c_new = cost(near_id) + distance(treeVertex(near_id), x_new);
+      if (c_new < c_min) {
+        min_id = near_id;
+        c_min = c_new;
       }
     }
 
-    // update the best parent for the goal vertex every n iterations
-    iter_no_lck.lock();
-    bool update_solution_path = (curr_iter_no_ % update_goal_every_ == 0);
-    iter_no_lck.unlock();
-    if (update_solution_path) {
-      if (x_soln_.size() > 0) {
-        std::shared_ptr<Vertex> best_goal_parent;
-        double min_goal_parent_cost = std::numeric_limits<double>::infinity();
-
-        for (const auto &v : x_soln_) {
-          double c = cost(v);
-          if (c < min_goal_parent_cost) {
-            min_goal_parent_cost = c;
-            best_goal_parent = v;
-          }
-        }
-        goal.parent = best_goal_parent;
+    const std::uint32_t new_id =
+        vertices_.addReserved(x_new.x, x_new.y, min_id, c_min);
+    is_edge_checked_[new_id] = !lazy;
+    recordVertex(new_id);
+
+    // rewiring
+    for (std::size_t k = 0u; k < no_of_near; ++k) {
+      if (w.near_flags[k] != FREE) continue;
+      const std::uint32_t near_id = w.near_ids[k];
+      double c_near = c_min + distance(x_new, treeVertex(near_id));
+      if (c_near < cost(near_id)) {
+        // the whole subtree of x_near gets cheaper by the same amount
+        vertices_.reparent(near_id, new_id, c_near);
+        is_edge_checked_[near_id] = !lazy;
+        recordRewire(near_id);
       }
     }
-    iter_no_lck.lock();
-    curr_iter_no_++;
-    iter_no_lck.unlock();
-  } else {
-    std::cout << "Iterations number reach max limit. Planning stopped." << '\n';
-    solved = true;
+
+    // add into x_soln if the vertex is within the goal radius
+    if (inGoalRegion(x_new)) {
+      x_soln_.push_back(new_id);
+    }
+    write_lck.unlock();
+
+    // publish the new vertex to the other workers
+    indexVertex(new_id);
+  }
+  no_of_collision_checks_ += no_of_checks;
+
+  // update the best parent for the goal vertex every n iterations
+  if (iter_no % update_goal_every_ == 0) updateGoal(goal);
+}
+
+void RRT_STAR::updateGoal(Vertex &goal) {
+  std::unique_lock<std::shared_mutex> write_lck(tree_mutex_);
+
+  // in lazy mode the path of the best candidate is checked first, an invalid
+  // edge on it is repaired and the candidates are compared again
+  while (x_soln_.size() > 0) {
+    std::uint32_t best_goal_parent = NO_VERTEX;
+    double min_goal_parent_cost = std::numeric_limits<double>::infinity();
+
+    for (const std::uint32_t id : x_soln_) {
+      double c = cost(id);
+      if (c < min_goal_parent_cost) {
+        min_goal_parent_cost = c;
+        best_goal_parent = id;
+      }
+    }
+    if (lazy_collision_checking_ && !validatePath(best_goal_parent)) continue;
+
+    if (best_goal_parent != goal.parent) {
+      recordSolution(best_goal_parent);
+      goal.parent = best_goal_parent;
+    }
+    return;
+  }
+
+  // every candidate was pruned by the repairs
+  if (goal.parent != NO_VERTEX && is_pruned_[goal.parent]) {
+    recordSolution(NO_VERTEX);
+    goal.parent = NO_VERTEX;
+  }
+}
+
+double RRT_STAR::bestSolutionCost(const Vertex &goal) const {
+  // lazy candidates may hide invalid edges until updateGoal() checks them
+  if (lazy_collision_checking_ || x_soln_.empty()) return solutionCost(goal);
+  std::uint32_t best = x_soln_.front();
+  for (const std::uint32_t id : x_soln_) {
+    if (cost(id) < cost(best)) best = id;
   }
+  return cost(best) + distance(treeVertex(best), goal);
 }
 
-void RRT_STAR::near(const std::shared_ptr<const Vertex> &x_new,
-                    std::vector<std::shared_ptr<Vertex>> &X_near) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  double r = std::min(
-      r_rrt_ * std::pow(std::log(static_cast<double>(vertices_.size())) /
-                            (static_cast<double>(vertices_.size())),
-                        1.0 / 2.0),
-      range_);
-
-  for (const auto &v : vertices_) {
-    if (distance(v, x_new) < r) {
-      X_near.emplace_back(v);
+bool RRT_STAR::validatePath(std::uint32_t id) {
+  for (std::uint32_t child = id; vertices_.parent[child] != NO_VERTEX;
+       child = vertices_.parent[child]) {
+    if (is_edge_checked_[child]) continue;
+    ++no_of_collision_checks_;
+    if (isCollision(treeVertex(vertices_.parent[child]), treeVertex(child))) {
+      repairEdge(child);
+      return false;
     }
+    is_edge_checked_[child] = 1u;
   }
+  return true;
+}
+
+void RRT_STAR::repairEdge(std::uint32_t id) {
+  ++no_of_repairs_;
+  const Vertex x = treeVertex(id);
+  std::vector<std::uint32_t> &near_ids = worker().near_ids;
+  near(x, near_ids);
+
+  // candidate parents by the cost they would give, cheapest first
+  std::vector<std::pair<double, std::uint32_t>> candidates;
+  for (const std::uint32_t near_id : near_ids) {
+    if (near_id == id || near_id == vertices_.parent[id]) continue;
+    candidates.push_back(
+        {cost(near_id) + distance(treeVertex(near_id), x), near_id});
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  auto is_descendant = [this, id](std::uint32_t v) {
+    for (; v != NO_VERTEX; v = vertices_.parent[v]) {
+      if (v == id) return true;
+    }
+    return false;
+  };
+  for (const auto &candidate : candidates) {
+    if (is_descendant(candidate.second)) continue;
+    ++no_of_collision_checks_;
+    if (isCollision(treeVertex(candidate.second), x)) continue;
+    vertices_.reparent(id, candidate.second, candidate.first);
+    is_edge_checked_[id] = 1u;
+    recordRewire(id);
+    return;
+  }
+
+  // no valid parent around, the whole subtree leaves the tree
+  std::vector<std::uint32_t> subtree{id};
+  for (std::size_t k = 0u; k < subtree.size(); ++k) {
+    for (std::uint32_t child = vertices_.first_child[subtree[k]];
+         child != NO_VERTEX; child = vertices_.next_sibling[child]) {
+      subtree.push_back(child);
+    }
+  }
+  for (const std::uint32_t v : subtree) {
+    vertices_.detach(v);
+    is_pruned_[v] = 1u;
+    recordPrune(v);
+  }
+
+  std::unique_lock<std::shared_mutex> nn_lck(nn_mutex_);
+  nn_->clear();
+  const std::uint32_t n = static_cast<std::uint32_t>(vertices_.size());
+  for (std::uint32_t v = 0u; v < n; ++v) {
+    if (!is_pruned_[v]) nn_->add(v, vertices_.x[v], vertices_.y[v]);
+  }
+  x_soln_.erase(std::remove_if(x_soln_.begin(), x_soln_.end(),
+                               [this](std::uint32_t v) {
+                                 return is_pruned_[v] != 0u;
+                               }),
+                x_soln_.end());
+}
+
+void RRT_STAR::near(const Vertex &x_new, std::vector<std::uint32_t> &X_near) {
+  X_near.clear();
+  std::shared_lock<std::shared_mutex> lock(nn_mutex_);
+
+  // the radius shrinks with the number of vertices in the tree
+  const double n = static_cast<double>(nn_->size());
+  double r = std::min(r_rrt_ * std::pow(std::log(n) / n, 1.0 / 2.0), range_);
+  nn_->radius(x_new.x, x_new.y, r, X_near);
 }
 
 }  // namespace sampling_based
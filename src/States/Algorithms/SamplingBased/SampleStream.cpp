@@ -0,0 +1,123 @@
+#include "States/Algorithms/SamplingBased/SampleStream.h"
+
+namespace path_finding_visualizer {
+namespace sampling_based {
+
+namespace {
+// quasi-random workers start this far apart in the sequence
+constexpr int WORKER_BLOCK_BITS = 24;
+
+// 2^-32
+constexpr double INV_2_32 = 1.0 / 4294967296.0;
+
+double radicalInverse(std::uint64_t i, unsigned int base) {
+  const double inv_base = 1.0 / base;
+  double f = inv_base, r = 0.0;
+  for (; i > 0u; i /= base) {
+    r += f * static_cast<double>(i % base);
+    f *= inv_base;
+  }
+  return r;
+}
+
+// direction numbers of the second Sobol dimension, primitive polynomial
+// x + 1, the first dimension is the base 2 van der Corput sequence
+struct SobolDirections {
+  std::uint32_t v[32];
+  SobolDirections() {
+    v[0] = 1u << 31;
+    for (int k = 1; k < 32; ++k) v[k] = v[k - 1] ^ (v[k - 1] >> 1);
+  }
+};
+const SobolDirections SOBOL_Y;
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////
+//   UniformStream
+////////////////////////////////////////////////////////////////////////
+
+UniformStream::UniformStream(std::uint32_t seed, std::size_t worker) {
+  std::seed_seq seq{seed, static_cast<std::uint32_t>(worker)};
+  rn_gen_.seed(seq);
+}
+
+void UniformStream::generate(double *xs, double *ys, std::size_t n) {
+  std::uniform_real_distribution<> dis(0, 1);
+  for (std::size_t i = 0u; i < n; ++i) {
+    xs[i] = dis(rn_gen_);
+    ys[i] = dis(rn_gen_);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+//   HaltonStream
+////////////////////////////////////////////////////////////////////////
+
+HaltonStream::HaltonStream(std::uint32_t seed, std::size_t worker)
+    : index_{static_cast<std::uint64_t>(worker) << WORKER_BLOCK_BITS} {
+  std::mt19937 rn_gen(seed);
+  std::uniform_real_distribution<> dis(0, 1);
+  shift_x_ = dis(rn_gen);
+  shift_y_ = dis(rn_gen);
+}
+
+void HaltonStream::generate(double *xs, double *ys, std::size_t n) {
+  for (std::size_t i = 0u; i < n; ++i, ++index_) {
+    const double x = radicalInverse(index_, 2u) + shift_x_;
+    const double y = radicalInverse(index_, 3u) + shift_y_;
+    xs[i] = x < 1.0 ? x : x - 1.0;
+    ys[i] = y < 1.0 ? y : y - 1.0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+//   SobolStream
+////////////////////////////////////////////////////////////////////////
+
+SobolStream::SobolStream(std::uint32_t seed, std::size_t worker)
+    : index_{static_cast<std::uint32_t>(worker) << WORKER_BLOCK_BITS},
+      x_{0u},
+      y_{0u} {
+  std::mt19937 rn_gen(seed);
+  shift_x_ = static_cast<std::uint32_t>(rn_gen());
+  shift_y_ = static_cast<std::uint32_t>(rn_gen());
+
+  // jump to the first point of the block through its gray code
+  const std::uint32_t gray = index_ ^ (index_ >> 1);
+  for (int k = 0; k < 32; ++k) {
+    if (gray & (1u << k)) {
+      x_ ^= 1u << (31 - k);
+      y_ ^= SOBOL_Y.v[k];
+    }
+  }
+}
+
+void SobolStream::generate(double *xs, double *ys, std::size_t n) {
+  for (std::size_t i = 0u; i < n; ++i) {
+    xs[i] = (x_ ^ shift_x_) * INV_2_32;
+    ys[i] = (y_ ^ shift_y_) * INV_2_32;
+
+    // consecutive gray codes differ in the lowest zero bit of the index
+    int k = 0;
+    while (index_ & (1u << k)) ++k;
+    x_ ^= 1u << (31 - k);
+    y_ ^= SOBOL_Y.v[k];
+    ++index_;
+  }
+}
+
+std::unique_ptr<SampleStream> makeSampleStream(int sampler, std::uint32_t seed,
+                                               std::size_t worker) {
+  switch (sampler) {
+    case SAMPLER_HALTON:
+      return std::make_unique<HaltonStream>(seed, worker);
+    case SAMPLER_SOBOL:
+      return std::make_unique<SobolStream>(seed, worker);
+    case SAMPLER_UNIFORM:
+    default:
+      return std::make_unique<UniformStream>(seed, worker);
+  }
+}
+
+}  // namespace sampling_based
+}  // namespace path_finding_visualizer
@@ -1,12 +1,26 @@
 #include "States/Algorithms/SamplingBased/SamplingBased.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
 namespace path_finding_visualizer {
 namespace sampling_based {
 
+thread_local std::size_t SamplingBased::worker_index_ = 0u;
+
 // Constructor
 SamplingBased::SamplingBased(std::shared_ptr<gui::LoggerPanel> logger_panel,
+                             std::shared_ptr<ThreadPool> thread_pool,
                              const std::string& name)
-    : State(logger_panel), key_time_max_{1.f}, key_time_{0.f} {
+    : State(logger_panel, thread_pool),
+      key_time_max_{1.f},
+      key_time_{0.f},
+      benchmark_{logger_panel, thread_pool} {
   logger_panel_->info("Initialize " + name + " planner");
   initVariables();
 
@@ -19,11 +33,9 @@ SamplingBased::SamplingBased(std::shared_ptr<gui::LoggerPanel> logger_panel,
 
 // Destructor
 SamplingBased::~SamplingBased() {
-  if (!thread_joined_) {
-    std::unique_lock<std::mutex> lck(mutex_);
-    is_stopped_ = false;
-    lck.unlock();
-    t_.join();
+  if (solver_.valid()) {
+    is_stopped_.store(true, std::memory_order_release);
+    solver_.wait();
   }
 }
 
@@ -31,10 +43,15 @@ void SamplingBased::initMapVariables() {
   map_width_ = 700;
   map_height_ = 700;
   obst_size_ = 20;
+  obstacle_tool_ = TOOL_SQUARE;
+  square_size_ = 20;
+  no_of_random_obstacles_ = 100;
 }
 
 void SamplingBased::initVariables() {
   initMapVariables();
+  updateObstacles();
+  is_dragging_ = false;
 
   message_queue_ = std::make_shared<MessageQueue<bool>>();
 
@@ -42,9 +59,23 @@ void SamplingBased::initVariables() {
   is_initialized_ = false;
   is_reset_ = false;
   is_solved_ = false;
-  is_stopped_ = false;
-  thread_joined_ = true;
+  is_resuming_ = false;
+  is_stopped_.store(false, std::memory_order_relaxed);
   disable_gui_parameters_ = false;
+  replay_solution_ = Trace::NO_PARENT;
+  replay_bins_.resize(REPLAY_BINS * REPLAY_BINS);
+  replay_max_edge_ = 0.f;
+  tree_lines_.setPrimitiveType(sf::Lines);
+  roadmap_lines_.setPrimitiveType(sf::Lines);
+  nn_backend_ = NN_KDTREE;
+  nn_ = makeNearestNeighbors(nn_backend_);
+  no_of_threads_ = 1;
+  workers_.resize(1u);
+  seed_ = 0;
+  run_seed_ = 0u;
+  sampler_ = SAMPLER_UNIFORM;
+  goal_bias_ = 0.0;
+  is_recording_ = true;
   disable_run_ = false;
 }
 
@@ -86,23 +117,18 @@ void SamplingBased::update(const float& dt, const ImVec2& mousePos) {
     is_initialized_ = false;
     is_reset_ = false;
     is_solved_ = false;
+    is_resuming_ = false;
     disable_gui_parameters_ = false;
 
-    std::unique_lock<std::mutex> lck(mutex_);
-    is_stopped_ = true;
-    lck.unlock();
-
-    if (!thread_joined_) {
-      t_.join();
-      thread_joined_ = true;
-    }
+    is_stopped_.store(true, std::memory_order_release);
+    if (solver_.valid()) solver_.get();
 
     message_queue_ = std::make_shared<MessageQueue<bool>>();
 
     initialize();
-
-    std::unique_lock<std::mutex> iter_no_lck(iter_no_mutex_);
-    curr_iter_no_ = 0u;
+    resetTrace();
+    curr_iter_no_.store(0u, std::memory_order_relaxed);
+    iteration_limit_ = 0u;
   }
 
   if (is_running_) {
@@ -110,44 +136,202 @@ void SamplingBased::update(const float& dt, const ImVec2& mousePos) {
 
     // initialize Algorithm
     if (!is_initialized_) {
-      initPlanner();
+      const bool is_resumed = is_resuming_;
+      if (is_resumed) {
+        resumeRun();
+      } else {
+        initRun();
+      }
+
+      run_time_ = rate_timer_ = 0.f;
+      rate_iter_no_ = curr_iter_no_.load(std::memory_order_relaxed);
+      iterations_per_sec_ = 0.f;
+      rate_history_.clear();
 
-      std::unique_lock<std::mutex> lck(mutex_);
-      is_stopped_ = false;
-      lck.unlock();
+      is_stopped_.store(false, std::memory_order_relaxed);
 
-      logger_panel_->info("Planning started with " +
-                          std::to_string(max_iterations_) + " iterations.");
+      if (is_resumed) {
+        logger_panel_->info("Refinement resumed with " +
+                            std::to_string(max_iterations_) +
+                            " more iterations on a tree of " +
+                            std::to_string(vertices_.size()) + " vertices.");
+      } else {
+        logger_panel_->info(
+            "Planning started with " + std::to_string(max_iterations_) +
+            " iterations on " + std::to_string(workers_.size()) +
+            " thread(s), " + SAMPLER_NAMES[sampler_] + " samples, seed " +
+            std::to_string(run_seed_) + ".");
+      }
 
-      // create thread
-      // solve the algorithm concurrently
-      t_ = std::thread(&SamplingBased::solveConcurrently, this, start_vertex_,
-                       goal_vertex_, message_queue_);
+      // solve the algorithm concurrently on the thread pool
+      solver_ = thread_pool_->submit([this, start = start_vertex_,
+                                      goal = goal_vertex_,
+                                      queue = message_queue_]() {
+        solveConcurrently(start, goal, queue);
+      });
 
-      thread_joined_ = false;
       is_initialized_ = true;
       disable_gui_parameters_ = true;
     }
 
+    updatePlanningRate(dt);
+
     // check the algorithm is solved or not
-    auto solved = message_queue_->receive();
+    bool solved = false;
     // if solved
-    if (solved) {
-      t_.join();
-      thread_joined_ = true;
+    if (message_queue_->tryReceive(solved) && solved) {
+      solver_.get();
       is_running_ = false;
       is_solved_ = true;
       logger_panel_->info(
           "Iterations number reach max limit. Planning stopped.");
+
+      const unsigned int iterations =
+          curr_iter_no_.load(std::memory_order_relaxed);
+      char buf[128];
+      std::snprintf(buf, sizeof(buf),
+                    "%u iterations in %.2f s (%.0f iterations/s) using %s "
+                    "nearest neighbours",
+                    iterations, run_time_,
+                    run_time_ > 0.f ? iterations / run_time_ : 0.f,
+                    NN_BACKEND_NAMES[nn_backend_].c_str());
+      logger_panel_->info(buf);
+      logSmoothing();
     }
   } else {
     // only allow mouse and key inputs
     // if the algorithm is not running
     updateUserInput();
   }
+
+  benchmark_.update();
+
+  // animate the recorded planner events
+  updateReplay(dt);
+}
+
+void SamplingBased::initRun() {
+  resetTrace();
+  trace_.setDimensions(static_cast<std::uint32_t>(map_width_),
+                       static_cast<std::uint32_t>(map_height_));
+  nn_->clear();
+
+  // one state per worker, all seeded from the run seed
+  run_seed_ = seed_ != 0 ? static_cast<std::uint32_t>(seed_)
+                         : static_cast<std::uint32_t>(rn_gen_());
+  rn_gen_.seed(run_seed_);
+  workers_.resize(supportsParallelGrowth()
+                      ? static_cast<std::size_t>(no_of_threads_)
+                      : 1u);
+  for (std::size_t k = 0u; k < workers_.size(); ++k) {
+    WorkerState& w = workers_[k];
+    w.rn_gen.seed(rn_gen_());
+    w.stream = makeSampleStream(sampler_, run_seed_, k);
+    w.sample_xs.clear();
+    w.sample_ys.clear();
+    w.next_sample = 0u;
+  }
+
+  curr_iter_no_.store(0u, std::memory_order_relaxed);
+  iteration_limit_ = static_cast<unsigned int>(max_iterations_);
+  no_of_collision_checks_ = 0u;
+
+  initPlanner();
+}
+
+void SamplingBased::resumeRun() {
+  // the trace, the sample streams & the counters carry on from the last run
+  is_resuming_ = false;
+  iteration_limit_ = curr_iter_no_.load(std::memory_order_relaxed) +
+                     static_cast<unsigned int>(max_iterations_);
+  resumePlanner();
+}
+
+void SamplingBased::reuseTree() {
+  const auto t0 = std::chrono::steady_clock::now();
+  reconnectGoal(*goal_vertex_);
+  const double ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - t0)
+                        .count();
+
+  char buf[128];
+  if (goal_vertex_->parent != NO_VERTEX) {
+    std::snprintf(buf, sizeof(buf),
+                  "Goal reconnected in %.3f ms, path cost %.3f", ms,
+                  solutionCost(*goal_vertex_));
+  } else {
+    std::snprintf(buf, sizeof(buf),
+                  "Goal could not be reconnected (%.3f ms)", ms);
+  }
+  logger_panel_->info(buf);
+
+  // a resumed run smooths its final path on the solver, otherwise the
+  // reconnected path is smoothed here
+  if (!refinesSolution()) {
+    smoothSolution(*goal_vertex_);
+    return;
+  }
+
+  // refine the reused tree towards the new goal
+  is_resuming_ = true;
+  is_solved_ = false;
+  is_initialized_ = false;
+  is_running_ = true;
+}
+
+void SamplingBased::updatePlanningRate(const float& dt) {
+  run_time_ += dt;
+  rate_timer_ += dt;
+  if (rate_timer_ < 0.25f) return;
+
+  const unsigned int iter_no = curr_iter_no_.load(std::memory_order_relaxed);
+
+  iterations_per_sec_ = (iter_no - rate_iter_no_) / rate_timer_;
+  rate_history_.push_back(iterations_per_sec_);
+  rate_iter_no_ = iter_no;
+  rate_timer_ = 0.f;
 }
 
 void SamplingBased::updateUserInput() {
+  const sf::Vector2f relative_mouse_pos =
+      sf::Vector2f(mousePositionWindow_.x - init_grid_xy_.x,
+                   mousePositionWindow_.y - init_grid_xy_.y);
+
+  // the previews follow the cursor, so the scene is redrawn every frame
+  if (is_dragging_ || !polygon_xs_.empty()) markSceneChanged();
+
+  // a dragged rectangle is added once the button is released
+  if (is_dragging_) {
+    if (!sf::Mouse::isButtonPressed(sf::Mouse::Left)) {
+      is_dragging_ = false;
+      const float x = std::min(std::max(relative_mouse_pos.x, 0.f),
+                               static_cast<float>(map_width_));
+      const float y = std::min(std::max(relative_mouse_pos.y, 0.f),
+                               static_cast<float>(map_height_));
+      if (std::fabs(x - drag_start_.x) >= 1.f &&
+          std::fabs(y - drag_start_.y) >= 1.f) {
+        obstacles_.addRect(drag_start_.x, drag_start_.y, x - drag_start_.x,
+                           y - drag_start_.y);
+        updateObstacles();
+        markSceneChanged();
+      }
+    }
+    return;
+  }
+
+  // Enter closes the open polygon into its convex hull, right drags stay
+  // free to pan the view
+  if (!polygon_xs_.empty() && sf::Keyboard::isKeyPressed(sf::Keyboard::Enter) &&
+      !ImGui::GetIO().WantTextInput && getKeyTime()) {
+    if (obstacles_.addPolygon(polygon_xs_, polygon_ys_)) {
+      updateObstacles();
+      markSceneChanged();
+    }
+    polygon_xs_.clear();
+    polygon_ys_.clear();
+    return;
+  }
+
   if (sf::Mouse::isButtonPressed(sf::Mouse::Left) && getKeyTime()) {
     if (mousePositionWindow_.x > init_grid_xy_.x + obst_size_ / 2 &&
         mousePositionWindow_.x <
@@ -155,17 +339,15 @@ void SamplingBased::updateUserInput() {
         mousePositionWindow_.y > init_grid_xy_.y + obst_size_ / 2 &&
         mousePositionWindow_.y <
             init_grid_xy_.y + map_height_ - obst_size_ / 2) {
+      markSceneChanged();
       bool setObstacle = true;
-      sf::Vector2f relative_mouse_pos =
-          sf::Vector2f(mousePositionWindow_.x - init_grid_xy_.x,
-                       mousePositionWindow_.y - init_grid_xy_.y);
-
-      for (std::size_t i = 0, e = obstacles_.size(); i != e; ++i) {
-        if (obstacles_[i]->getGlobalBounds().contains(relative_mouse_pos)) {
-          obstacles_.erase(obstacles_.begin() + i);
-          setObstacle = false;
-          break;
-        }
+
+      const std::size_t hit =
+          obstacles_.pick(relative_mouse_pos.x, relative_mouse_pos.y);
+      if (hit != ObstacleSet::NONE) {
+        obstacles_.remove(hit);
+        updateObstacles();
+        setObstacle = false;
       }
 
       if (!is_solved_) {
@@ -190,18 +372,39 @@ void SamplingBased::updateUserInput() {
         } else {
           // add new obstacle
           if (setObstacle) {
-            std::shared_ptr<sf::RectangleShape> obstShape =
-                std::make_shared<sf::RectangleShape>(
-                    sf::Vector2f(obst_size_, obst_size_));
-            obstShape->setPosition(
-                sf::Vector2f(relative_mouse_pos.x - obst_size_ / 2.,
-                             relative_mouse_pos.y - obst_size_ / 2.));
-            obstShape->setFillColor(OBST_COL);
-            obstacles_.emplace_back(std::move(obstShape));
+            switch (obstacle_tool_) {
+              case TOOL_RECTANGLE:
+                is_dragging_ = true;
+                drag_start_ = relative_mouse_pos;
+                break;
+              case TOOL_POLYGON:
+                polygon_xs_.push_back(relative_mouse_pos.x);
+                polygon_ys_.push_back(relative_mouse_pos.y);
+                break;
+              case TOOL_SQUARE:
+              default:
+                obstacles_.addRect(relative_mouse_pos.x - square_size_ / 2.f,
+                                   relative_mouse_pos.y - square_size_ / 2.f,
+                                   square_size_, square_size_);
+                updateObstacles();
+                break;
+            }
           }
         }
       } else {
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl)) {
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::LShift)) {
+          // the start can only move if the planner answers the new query
+          if (setObstacle && supportsRequery()) {
+            start_vertex_->y =
+                utils::map(mousePositionWindow_.x, init_grid_xy_.x,
+                           init_grid_xy_.x + map_width_, 0.0, 1.0);
+            start_vertex_->x =
+                utils::map(mousePositionWindow_.y, init_grid_xy_.y,
+                           init_grid_xy_.y + map_height_, 0.0, 1.0);
+            requery();
+            smoothSolution(*goal_vertex_);
+          }
+        } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl)) {
           if (setObstacle) {
             goal_vertex_->y =
                 utils::map(mousePositionWindow_.x, init_grid_xy_.x,
@@ -210,7 +413,12 @@ void SamplingBased::updateUserInput() {
                 utils::map(mousePositionWindow_.y, init_grid_xy_.y,
                            init_grid_xy_.y + map_height_, 0.0, 1.0);
 
-            // TODO: Find nearest node from goal point and set it as parent
+            if (supportsRequery()) {
+              requery();
+              smoothSolution(*goal_vertex_);
+            } else if (supportsGoalReuse()) {
+              reuseTree();
+            }
           }
         }
       }
@@ -228,26 +436,226 @@ void SamplingBased::renderMap(sf::RenderTexture& render_texture) {
 }
 
 void SamplingBased::renderObstacles(sf::RenderTexture& render_texture) {
-  for (auto& shape : obstacles_) {
-    sf::RectangleShape obst(sf::Vector2f(obst_size_, obst_size_));
-    obst.setPosition(sf::Vector2f(init_grid_xy_.x + shape->getPosition().x,
-                                  init_grid_xy_.y + shape->getPosition().y));
-    obst.setFillColor(OBST_COL);
-    render_texture.draw(obst);
+  // all obstacles go out in one draw call
+  sf::RenderStates states;
+  states.transform.translate(init_grid_xy_);
+  render_texture.draw(obstacle_triangles_, states);
+
+  // outline of the rectangle being dragged
+  if (is_dragging_) {
+    const sf::Vector2f corner = init_grid_xy_ + drag_start_;
+    sf::RectangleShape rect(mousePositionWindow_ - corner);
+    rect.setPosition(corner);
+    rect.setFillColor(sf::Color(0, 0, 0, 64));
+    rect.setOutlineThickness(1.f);
+    rect.setOutlineColor(OBST_COL);
+    render_texture.draw(rect);
+  }
+
+  // corners of the open polygon, joined up to the cursor
+  if (!polygon_xs_.empty()) {
+    sf::VertexArray outline(sf::LineStrip);
+    for (std::size_t i = 0u; i < polygon_xs_.size(); ++i) {
+      outline.append(sf::Vertex(
+          init_grid_xy_ + sf::Vector2f(polygon_xs_[i], polygon_ys_[i]),
+          OBST_COL));
+    }
+    outline.append(sf::Vertex(mousePositionWindow_, OBST_COL));
+    render_texture.draw(outline);
   }
 }
 
-void SamplingBased::clearObstacles() { obstacles_.clear(); }
+void SamplingBased::renderReplayTree(sf::RenderTexture& render_texture) {
+  const auto texture_size = render_texture.getSize();
+  const sf::View& view = render_texture.getView();
+  const sf::Vector2f view_min = view.getCenter() - view.getSize() / 2.f;
+  const sf::Vector2f view_max = view_min + view.getSize();
+
+  // roadmap edges never change once recorded, they always go out in one call
+  if (roadmap_lines_.getVertexCount() > 0u) {
+    sf::RenderStates states;
+    states.transform.translate(init_grid_xy_).scale(map_width_, map_height_);
+    render_texture.draw(roadmap_lines_, states);
+  }
+
+  // while most of the map is visible the whole tree goes out in one draw
+  // call, culling only pays off once the view is zoomed into the map
+  if (view.getSize().x * view.getSize().y >=
+      0.25f * map_width_ * map_height_) {
+    sf::RenderStates states;
+    states.transform.translate(init_grid_xy_).scale(map_width_, map_height_);
+    render_texture.draw(tree_lines_, states);
+    return;
+  }
+
+  // screen pixels per scene unit
+  const float pixel_scale = texture_size.x / view.getSize().x;
+
+  // maps a normalized vertex position into the planning scene
+  auto to_scene = [this](const sf::Vector2f& v) {
+    return sf::Vector2f(init_grid_xy_.x + v.y * map_width_,
+                        init_grid_xy_.y + v.x * map_height_);
+  };
+
+  // bins touched by the view, grown by the longest edge so that edges
+  // crossing into the view from outside are kept
+  auto bin_range = [this](float lo, float hi, int& first, int& last) {
+    first = std::max(
+        static_cast<int>(std::floor((lo - replay_max_edge_) * REPLAY_BINS)), 0);
+    last = std::min(
+        static_cast<int>(std::floor((hi + replay_max_edge_) * REPLAY_BINS)),
+        REPLAY_BINS - 1);
+  };
+  int row_first, row_last, col_first, col_last;
+  bin_range((view_min.y - init_grid_xy_.y) / map_height_,
+            (view_max.y - init_grid_xy_.y) / map_height_, row_first, row_last);
+  bin_range((view_min.x - init_grid_xy_.x) / map_width_,
+            (view_max.x - init_grid_xy_.x) / map_width_, col_first, col_last);
+
+  edge_vertices_.setPrimitiveType(sf::Lines);
+  edge_vertices_.clear();
+  point_vertices_.setPrimitiveType(sf::Points);
+  point_vertices_.clear();
+
+  // edges shorter than a pixel collapse into one point per pixel
+  const std::size_t no_of_pixels =
+      static_cast<std::size_t>(texture_size.x) * texture_size.y;
+  if (pixel_frames_.size() != no_of_pixels) {
+    pixel_frames_.assign(no_of_pixels, 0u);
+    frame_no_ = 0u;
+  }
+  ++frame_no_;
+
+  for (int r = row_first; r <= row_last; ++r) {
+    for (int c = col_first; c <= col_last; ++c) {
+      for (const std::uint32_t id : replay_bins_[r * REPLAY_BINS + c]) {
+        const std::uint32_t parent = replay_parents_[id];
+        if (parent == Trace::NO_PARENT) continue;
+
+        const sf::Vector2f p1 = to_scene(replay_vertices_[id]);
+        const sf::Vector2f p2 = to_scene(replay_vertices_[parent]);
+        if (std::max(p1.x, p2.x) < view_min.x ||
+            std::min(p1.x, p2.x) > view_max.x ||
+            std::max(p1.y, p2.y) < view_min.y ||
+            std::min(p1.y, p2.y) > view_max.y) {
+          continue;
+        }
+
+        const sf::Vector2f d = (p2 - p1) * pixel_scale;
+        if (std::fabs(d.x) >= 1.f || std::fabs(d.y) >= 1.f) {
+          edge_vertices_.append(sf::Vertex(p1, EDGE_COL));
+          edge_vertices_.append(sf::Vertex(p2, EDGE_COL));
+          continue;
+        }
+
+        const int px = static_cast<int>((p1.x - view_min.x) * pixel_scale);
+        const int py = static_cast<int>((p1.y - view_min.y) * pixel_scale);
+        if (px < 0 || py < 0 || px >= static_cast<int>(texture_size.x) ||
+            py >= static_cast<int>(texture_size.y)) {
+          continue;
+        }
+        std::uint32_t& frame =
+            pixel_frames_[static_cast<std::size_t>(py) * texture_size.x + px];
+        if (frame == frame_no_) continue;
+        frame = frame_no_;
+        point_vertices_.append(sf::Vertex(p1, EDGE_COL));
+      }
+    }
+  }
+
+  render_texture.draw(edge_vertices_);
+  render_texture.draw(point_vertices_);
+}
+
+void SamplingBased::clearObstacles() {
+  obstacles_.clear();
+  polygon_xs_.clear();
+  polygon_ys_.clear();
+  updateObstacles();
+  markSceneChanged();
+}
+
+void SamplingBased::updateObstacles() {
+  ++obstacles_revision_;
+  obstacles_.build();
+
+  // convex obstacles are fans of triangles around their first corner
+  obstacle_triangles_.setPrimitiveType(sf::Triangles);
+  obstacle_triangles_.clear();
+  for (std::size_t i = 0u; i < obstacles_.size(); ++i) {
+    const ObstacleSet::Obstacle& o = obstacles_[i];
+    const std::uint32_t last = o.first_vertex + o.no_of_vertices - 1u;
+    const sf::Vector2f p0(obstacles_.vertexX(o.first_vertex),
+                          obstacles_.vertexY(o.first_vertex));
+    for (std::uint32_t v = o.first_vertex + 1u; v < last; ++v) {
+      obstacle_triangles_.append(sf::Vertex(p0, OBST_COL));
+      obstacle_triangles_.append(sf::Vertex(
+          sf::Vector2f(obstacles_.vertexX(v), obstacles_.vertexY(v)),
+          OBST_COL));
+      obstacle_triangles_.append(sf::Vertex(
+          sf::Vector2f(obstacles_.vertexX(v + 1u), obstacles_.vertexY(v + 1u)),
+          OBST_COL));
+    }
+  }
+}
+
+void SamplingBased::generateObstacles(int no_of_obstacles) {
+  std::uniform_real_distribution<float> unit_dis(0.f, 1.f);
+  std::uniform_real_distribution<float> size_dis(0.5f * square_size_,
+                                                 2.f * square_size_);
+  // start & goal in map pixels
+  const sf::Vector2f start(start_vertex_->y * map_width_,
+                           start_vertex_->x * map_height_);
+  const sf::Vector2f goal(goal_vertex_->y * map_width_,
+                          goal_vertex_->x * map_height_);
+  std::vector<float> xs, ys;
+
+  // every other obstacle is a polygon through random points of a circle
+  for (int i = 0; i < no_of_obstacles; ++i) {
+    const float w = size_dis(rn_gen_), h = size_dis(rn_gen_);
+    const bool is_polygon = i % 2 == 1;
+    const float radius = is_polygon ? 0.5f * w : 0.5f * std::hypot(w, h);
+    if (2.f * radius >= std::min(map_width_, map_height_)) continue;
+    const float cx = radius + unit_dis(rn_gen_) * (map_width_ - 2.f * radius);
+    const float cy = radius + unit_dis(rn_gen_) * (map_height_ - 2.f * radius);
+
+    // the start & goal markers stay free
+    const float clearance = radius + obst_size_ / 2.f;
+    if (std::hypot(cx - start.x, cy - start.y) < clearance ||
+        std::hypot(cx - goal.x, cy - goal.y) < clearance) {
+      continue;
+    }
+
+    if (!is_polygon) {
+      obstacles_.addRect(cx - 0.5f * w, cy - 0.5f * h, w, h);
+      continue;
+    }
+    xs.clear();
+    ys.clear();
+    for (int k = 0; k < 6; ++k) {
+      const float angle = 2.f * static_cast<float>(M_PI) * unit_dis(rn_gen_);
+      xs.push_back(cx + radius * std::cos(angle));
+      ys.push_back(cy + radius * std::sin(angle));
+    }
+    obstacles_.addPolygon(xs, ys);
+  }
+  updateObstacles();
+  markSceneChanged();
+}
 
 void SamplingBased::renderGui() {
   ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 6.f);
   {
-    std::unique_lock<std::mutex> iter_no_lck(iter_no_mutex_);
+    const unsigned int iter_no = curr_iter_no_.load(std::memory_order_relaxed);
+    // the limit of the last run, the parameter until the first one
+    const unsigned int limit =
+        iteration_limit_ > 0u ? iteration_limit_
+                              : static_cast<unsigned int>(max_iterations_);
     const float progress = static_cast<float>(
-        utils::map(static_cast<double>(curr_iter_no_), 0.0,
-                   static_cast<double>(max_iterations_), 0.0, 1.0));
+        utils::map(static_cast<double>(iter_no), 0.0,
+                   static_cast<double>(limit), 0.0, 1.0));
     const std::string buf =
-        std::to_string(curr_iter_no_) + "/" + std::to_string(max_iterations_);
+        std::to_string(iter_no) + "/" + std::to_string(limit);
     ImGui::Text("Planning Progress:");
     ImGui::SameLine();
     gui::HelpMarker(
@@ -274,22 +682,41 @@ void SamplingBased::renderGui() {
     ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(8.f, 2.f));
 
     if (gui::inputInt("width", &map_width_, 500, 10000, 100, 1000)) {
+      markSceneChanged();
     }
     ImGui::PopStyleVar();
     if (gui::inputInt("height", &map_height_, 500, 10000, 100, 1000)) {
+      markSceneChanged();
     }
 
-    ImGui::Text("Random Obstacles:");
+    ImGui::Text("Obstacles:");
     ImGui::SameLine();
-    gui::HelpMarker("TODO: Randomly generate obstacles in the gridmap");
-    static int rand_obsts_no = 10;
-    if (ImGui::InputInt("##rand_obst_input", &rand_obsts_no, 1, 10,
-                        ImGuiInputTextFlags_EnterReturnsTrue)) {
-      // TODO:
+    gui::HelpMarker(
+        "Left click adds the selected shape or removes the obstacle under "
+        "the cursor.\nRectangles are dragged, polygon corners are clicked "
+        "one by one and Enter closes their convex hull.");
+    if (ImGui::BeginCombo("shape", OBSTACLE_TOOLS[obstacle_tool_].c_str())) {
+      for (int n = 0; n < static_cast<int>(OBSTACLE_TOOLS.size()); n++) {
+        const bool selected = (n == obstacle_tool_);
+        if (ImGui::Selectable(OBSTACLE_TOOLS[n].c_str(), selected)) {
+          obstacle_tool_ = n;
+          polygon_xs_.clear();
+          polygon_ys_.clear();
+        }
+      }
+      ImGui::EndCombo();
     }
+    gui::inputInt("size", &square_size_, 1, 500, 1, 10,
+                  "Side of the squares & mean size of random obstacles in "
+                  "map pixels");
+
+    ImGui::Text("Random Obstacles:");
+    ImGui::SameLine();
+    gui::HelpMarker("Randomly generate rectangles & convex polygons");
+    gui::inputInt("count", &no_of_random_obstacles_, 1, 100000, 10, 1000);
     ImGui::SameLine();
     if (ImGui::Button("Generate")) {
-      // TODO:
+      generateObstacles(no_of_random_obstacles_);
     }
 
     if (ImGui::Button("Clear Obstacles")) {
@@ -298,6 +725,7 @@ void SamplingBased::renderGui() {
     ImGui::SameLine();
     if (ImGui::Button("Restore Defaults##edit_restore")) {
       initMapVariables();
+      markSceneChanged();
     }
 
     ImGui::Unindent(8.f);
@@ -319,10 +747,57 @@ void SamplingBased::renderGui() {
     gui::inputInt("max_iterations", &max_iterations_, 1, 100000, 1, 1000,
                   "Maximum number of iterations to run the planner");
 
+    if (ImGui::BeginCombo("nearest neighbours",
+                          NN_BACKEND_NAMES[nn_backend_].c_str())) {
+      for (int n = 0; n < static_cast<int>(NN_BACKEND_NAMES.size()); n++) {
+        const bool selected = (n == nn_backend_);
+        if (ImGui::Selectable(NN_BACKEND_NAMES[n].c_str(), selected) &&
+            !selected) {
+          nn_backend_ = n;
+          nn_ = makeNearestNeighbors(nn_backend_);
+        }
+      }
+      ImGui::EndCombo();
+    }
+    ImGui::SameLine();
+    gui::HelpMarker(
+        "Spatial index used for nearest & near vertex queries.\nCompare "
+        "the iterations per second of each backend in the Stats panel.");
+
+    if (ImGui::BeginCombo("sampler", SAMPLER_NAMES[sampler_].c_str())) {
+      for (int n = 0; n < static_cast<int>(SAMPLER_NAMES.size()); n++) {
+        const bool selected = (n == sampler_);
+        if (ImGui::Selectable(SAMPLER_NAMES[n].c_str(), selected)) {
+          sampler_ = n;
+        }
+      }
+      ImGui::EndCombo();
+    }
+    ImGui::SameLine();
+    gui::HelpMarker(
+        "Stream of sample points.\nHalton & Sobol are quasi-random "
+        "sequences that cover the map more evenly than uniform samples.");
+
+    gui::inputInt("seed", &seed_, 0, 2147483647, 1, 100,
+                  "Seed of the run, 0 draws a new seed every run");
+
+    if (supportsGoalBias()) {
+      gui::inputDouble("goal_bias", &goal_bias_, 0.0, 1.0, 0.01, 0.1,
+                       "Probability of sampling the goal", "%.2f");
+    }
+
+    if (supportsParallelGrowth()) {
+      gui::inputInt("threads", &no_of_threads_, 1,
+                    static_cast<int>(thread_pool_->size()), 1, 1,
+                    "Number of workers sampling & growing the tree at once");
+    }
+
     // virtual function renderParametersGui()
     // need to be implemented by derived class
     renderParametersGui();
 
+    renderSmoothingGui();
+
     ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(8.f, 8.f));
     ImGui::Spacing();
     ImGui::PopStyleVar();
@@ -342,6 +817,8 @@ void SamplingBased::renderGui() {
 void SamplingBased::renderConfig() {
   // render gui
   renderGui();
+  benchmark_.renderGui(*this);
+  renderReplayGui();
 }
 
 void SamplingBased::renderScene(sf::RenderTexture& render_texture) {
@@ -356,6 +833,251 @@ void SamplingBased::renderScene(sf::RenderTexture& render_texture) {
   renderPlannerData(render_texture);
 }
 
+void SamplingBased::resetReplay() {
+  replay_vertices_.clear();
+  replay_parents_.clear();
+  replay_solution_ = Trace::NO_PARENT;
+  for (auto& bin : replay_bins_) bin.clear();
+  replay_max_edge_ = 0.f;
+  tree_lines_.clear();
+  roadmap_lines_.clear();
+}
+
+void SamplingBased::applyTraceEvent(const TraceEvent& e) {
+  switch (e.type) {
+    case TraceEventType::ADD_VERTEX:
+      if (e.id >= replay_vertices_.size()) {
+        replay_vertices_.resize(e.id + 1u);
+        replay_parents_.resize(e.id + 1u, Trace::NO_PARENT);
+      }
+      replay_vertices_[e.id] =
+          sf::Vector2f(Trace::dequantize(e.x), Trace::dequantize(e.y));
+      replay_parents_[e.id] = e.parent;
+      replay_bins_[replayBin(replay_vertices_[e.id])].push_back(e.id);
+      updateReplayMaxEdge(e.id);
+      updateTreeLine(e.id);
+      break;
+    case TraceEventType::REWIRE:
+      replay_parents_[e.id] = e.parent;
+      updateReplayMaxEdge(e.id);
+      updateTreeLine(e.id);
+      break;
+    case TraceEventType::SOLUTION:
+      replay_solution_ = e.id;
+      break;
+    case TraceEventType::ADD_EDGE: {
+      const sf::Vector2f& v1 = replay_vertices_[e.id];
+      const sf::Vector2f& v2 = replay_vertices_[e.parent];
+      roadmap_lines_.append(sf::Vertex(sf::Vector2f(v1.y, v1.x), ROADMAP_COL));
+      roadmap_lines_.append(sf::Vertex(sf::Vector2f(v2.y, v2.x), ROADMAP_COL));
+      break;
+    }
+    case TraceEventType::PRUNE:
+      // a pruned vertex keeps its position but loses its edge
+      replay_parents_[e.id] = Trace::NO_PARENT;
+      updateTreeLine(e.id);
+      break;
+    default:
+      break;
+  }
+}
+
+bool SamplingBased::exportReplay(const std::string& filename) const {
+  std::ofstream out(filename);
+  if (!out) return false;
+
+  std::vector<std::uint8_t> on_path(replay_vertices_.size(), 0u);
+  for (std::uint32_t id = replay_solution_; id != Trace::NO_PARENT;
+       id = replay_parents_[id]) {
+    on_path[id] = 1u;
+  }
+
+  // pruned vertices & roots are written with parent -1
+  out << "id,x,y,parent,on_path\n";
+  for (std::size_t id = 0u; id < replay_vertices_.size(); ++id) {
+    const std::uint32_t parent = replay_parents_[id];
+    out << id << ',' << replay_vertices_[id].x << ',' << replay_vertices_[id].y
+        << ',';
+    if (parent == Trace::NO_PARENT) {
+      out << -1;
+    } else {
+      out << parent;
+    }
+    out << ',' << static_cast<int>(on_path[id]) << '\n';
+  }
+  return static_cast<bool>(out);
+}
+
+std::size_t SamplingBased::replayBin(const sf::Vector2f& v) const {
+  const int row =
+      std::min(static_cast<int>(v.x * REPLAY_BINS), REPLAY_BINS - 1);
+  const int col =
+      std::min(static_cast<int>(v.y * REPLAY_BINS), REPLAY_BINS - 1);
+  return static_cast<std::size_t>(row) * REPLAY_BINS + col;
+}
+
+void SamplingBased::updateReplayMaxEdge(std::uint32_t id) {
+  const std::uint32_t parent = replay_parents_[id];
+  if (parent == Trace::NO_PARENT) return;
+  const sf::Vector2f d = replay_vertices_[id] - replay_vertices_[parent];
+  replay_max_edge_ =
+      std::max(replay_max_edge_, std::max(std::fabs(d.x), std::fabs(d.y)));
+}
+
+void SamplingBased::updateTreeLine(std::uint32_t id) {
+  // parallel workers may record ids slightly out of order, lines of ids
+  // not seen yet stay transparent
+  const std::size_t first = 2u * static_cast<std::size_t>(id);
+  const std::size_t count = tree_lines_.getVertexCount();
+  if (count < first + 2u) {
+    tree_lines_.resize(first + 2u);
+    for (std::size_t i = count; i < first; ++i) {
+      tree_lines_[i].color = sf::Color(0, 0, 0, 0);
+    }
+  }
+
+  // the root has no edge, its line is empty & transparent
+  const std::uint32_t parent = replay_parents_[id];
+  const sf::Vector2f& v = replay_vertices_[id];
+  const sf::Vector2f& p =
+      parent == Trace::NO_PARENT ? v : replay_vertices_[parent];
+  const sf::Color color =
+      parent == Trace::NO_PARENT ? sf::Color(0, 0, 0, 0) : EDGE_COL;
+
+  // vertex x maps to the vertical axis & vertex y to the horizontal axis
+  tree_lines_[first] = sf::Vertex(sf::Vector2f(v.y, v.x), color);
+  tree_lines_[first + 1u] = sf::Vertex(sf::Vector2f(p.y, p.x), color);
+}
+
+void SamplingBased::renderStats() {
+  const std::size_t no_of_vertices = vertices_.size();
+
+  ImGui::Text("Nearest neighbours: %s", NN_BACKEND_NAMES[nn_backend_].c_str());
+  ImGui::Text("Threads: %zu", workers_.size());
+  ImGui::Text("Samples: %s, seed %u", SAMPLER_NAMES[sampler_].c_str(),
+              run_seed_);
+  ImGui::Text("Obstacles: %zu (%.1f KB)", obstacles_.size(),
+              obstacles_.bytes() / 1024.0);
+  ImGui::Text("Tree vertices: %zu", no_of_vertices);
+  ImGui::Text("Collision checks: %zu", no_of_collision_checks_.load());
+  ImGui::Text("Iterations/s: %.0f", iterations_per_sec_);
+  if (!rate_history_.empty()) {
+    ImGui::PlotLines("##iterations_per_sec", rate_history_.data(),
+                     static_cast<int>(rate_history_.size()), 0,
+                     "iterations/s over the run", 0.f, 3.4e38f,
+                     ImVec2(0.f, 60.f));
+  }
+  if (is_solved_) renderSmoothingStats();
+  benchmark_.renderStats();
+  State::renderStats();
+}
+
+Vertex SamplingBased::treeVertex(std::uint32_t id) const {
+  // parents may be rewired concurrently, only positions are immutable
+  return Vertex{vertices_.x[id], vertices_.y[id]};
+}
+
+void SamplingBased::indexVertex(std::uint32_t id) {
+  std::unique_lock<std::shared_mutex> lock(nn_mutex_);
+  nn_->add(id, vertices_.x[id], vertices_.y[id]);
+}
+
+void SamplingBased::nextSample(double& x, double& y) {
+  WorkerState& w = worker();
+  if (w.next_sample == w.sample_xs.size()) {
+    w.sample_xs.resize(SAMPLE_BATCH);
+    w.sample_ys.resize(SAMPLE_BATCH);
+    w.stream->generate(w.sample_xs.data(), w.sample_ys.data(), SAMPLE_BATCH);
+    w.next_sample = 0u;
+  }
+  x = w.sample_xs[w.next_sample];
+  y = w.sample_ys[w.next_sample];
+  ++w.next_sample;
+}
+
+void SamplingBased::smoothSolution(const Vertex& goal) {
+  smoothed_path_.clear();
+  if (!smooth_path_ || goal.parent == NO_VERTEX) return;
+
+  std::vector<PathPoint> path{{goal.x, goal.y}};
+  for (std::uint32_t id = goal.parent; id != NO_VERTEX;
+       id = vertices_.parent[id]) {
+    path.push_back({vertices_.x[id], vertices_.y[id]});
+  }
+  std::reverse(path.begin(), path.end());
+
+  // same check as the planners, the spline is sampled every pixel
+  smoothPath(
+      std::move(path),
+      [this](const PathPoint& a, const PathPoint& b) {
+        return !obstacles_.segmentCollides(a.y * map_width_, a.x * map_height_,
+                                           b.y * map_width_, b.x * map_height_);
+      },
+      1.0 / std::max(map_width_, map_height_), run_seed_);
+}
+
+double SamplingBased::solutionCost(const Vertex& goal) const {
+  if (goal.parent == NO_VERTEX) return std::numeric_limits<double>::infinity();
+  double cost = std::hypot(goal.x - vertices_.x[goal.parent],
+                           goal.y - vertices_.y[goal.parent]);
+  for (std::uint32_t id = goal.parent; vertices_.parent[id] != NO_VERTEX;
+       id = vertices_.parent[id]) {
+    const std::uint32_t parent = vertices_.parent[id];
+    cost += std::hypot(vertices_.x[id] - vertices_.x[parent],
+                       vertices_.y[id] - vertices_.y[parent]);
+  }
+  return cost;
+}
+
+bool SamplingBased::claimIteration(unsigned int& iter_no) {
+  // never counts past iteration_limit_, unlike a plain fetch_add
+  const unsigned int max_iter_no = iteration_limit_;
+  unsigned int n = curr_iter_no_.load(std::memory_order_relaxed);
+  do {
+    if (n >= max_iter_no) return false;
+  } while (!curr_iter_no_.compare_exchange_weak(n, n + 1u,
+                                                std::memory_order_relaxed));
+  iter_no = n;
+  return true;
+}
+
+std::unique_lock<std::mutex> SamplingBased::lockTrace() {
+  std::unique_lock<std::mutex> lock(trace_mutex_, std::defer_lock);
+  if (workers_.size() > 1u) lock.lock();
+  return lock;
+}
+
+void SamplingBased::recordVertex(std::uint32_t id) {
+  if (!is_recording_) return;
+  const auto lock = lockTrace();
+  trace_.append({id, vertices_.parent[id], Trace::quantize(vertices_.x[id]),
+                 Trace::quantize(vertices_.y[id]), TraceEventType::ADD_VERTEX});
+}
+
+void SamplingBased::recordRewire(std::uint32_t id) {
+  if (!is_recording_) return;
+  const auto lock = lockTrace();
+  trace_.append({id, vertices_.parent[id], 0u, 0u, TraceEventType::REWIRE});
+}
+
+void SamplingBased::recordSolution(std::uint32_t id) {
+  if (!is_recording_) return;
+  const auto lock = lockTrace();
+  trace_.append({id, Trace::NO_PARENT, 0u, 0u, TraceEventType::SOLUTION});
+}
+
+void SamplingBased::recordEdge(std::uint32_t id1, std::uint32_t id2) {
+  if (!is_recording_) return;
+  const auto lock = lockTrace();
+  trace_.append({id1, id2, 0u, 0u, TraceEventType::ADD_EDGE});
+}
+
+void SamplingBased::recordPrune(std::uint32_t id) {
+  if (!is_recording_) return;
+  const auto lock = lockTrace();
+  trace_.append({id, Trace::NO_PARENT, 0u, 0u, TraceEventType::PRUNE});
+}
+
 void SamplingBased::solveConcurrently(
     std::shared_ptr<Vertex> start_point, std::shared_ptr<Vertex> goal_point,
     std::shared_ptr<MessageQueue<bool>> message_queue) {
@@ -365,40 +1087,34 @@ void SamplingBased::solveConcurrently(
   std::shared_ptr<Vertex> goal_vertex = goal_point;
   std::shared_ptr<MessageQueue<bool>> s_message_queue = message_queue;
 
-  bool solved = false;
-
-  double cycle_duration = 1;  // duration of a single simulation cycle in ms
-  // init stop watch
-  auto last_update = std::chrono::system_clock::now();
-
-  while (true) {
-    // compute time difference to stop watch
-    long time_since_last_update =
-        std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now() - last_update)
-            .count();
+  // set once any worker solves the problem or runs out of iterations
+  std::atomic<bool> solved{false};
 
-    if (time_since_last_update >= cycle_duration) {
+  // run the planner at full speed, the UI replays the recorded trace
+  auto grow = [&](std::size_t worker) {
+    worker_index_ = worker;
+    bool worker_solved = false;
+    while (!worker_solved && !solved.load(std::memory_order_acquire)) {
       // run the main algorithm
-      updatePlanner(solved, *start_vertex, *goal_vertex);
-
-      // reset stop watch for next cycle
-      last_update = std::chrono::system_clock::now();
+      updatePlanner(worker_solved, *start_vertex, *goal_vertex);
+      if (is_stopped_.load(std::memory_order_acquire)) break;
     }
+    // publishes the goal of the solving worker along with the flag
+    if (worker_solved) solved.store(true, std::memory_order_release);
+  };
 
-    // sends an update method to the message queue using move semantics
-    auto ftr = std::async(std::launch::async, &MessageQueue<bool>::send,
-                          s_message_queue, std::move(solved));
-    ftr.wait();
-
-    if (solved) return;
+  if (workers_.size() > 1u) {
+    thread_pool_->parallelFor(0u, workers_.size(), grow);
+  } else {
+    grow(0u);
+  }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (is_stopped_) return;
+  // post-process the solution before the UI takes over
+  const bool stopped = is_stopped_.load(std::memory_order_acquire);
+  if (solved.load() && !stopped) smoothSolution(*goal_vertex);
 
-    // sleep at every iteration to reduce CPU usage
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-  }
+  // notify the UI that the planner has finished
+  s_message_queue->send(solved.load());
 }
 
 }  // namespace sampling_based
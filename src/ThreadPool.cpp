@@ -0,0 +1,115 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace path_finding_visualizer {
+
+namespace {
+// pool & queue index of the calling thread, if it is a pool worker
+thread_local const ThreadPool *current_pool = nullptr;
+thread_local std::size_t current_index = 0u;
+}  // namespace
+
+ThreadPool::ThreadPool(unsigned no_of_threads) {
+  if (no_of_threads == 0u) {
+    // at least two workers, so one long planning job never starves the rest
+    no_of_threads = std::max(2u, std::thread::hardware_concurrency());
+  }
+
+  for (unsigned i = 0u; i < no_of_threads; ++i) {
+    queues_.emplace_back(new WorkQueue);
+  }
+  for (unsigned i = 0u; i < no_of_threads; ++i) {
+    workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (auto &worker : workers_) worker.join();
+}
+
+void ThreadPool::push(std::function<void()> task, const void *group) {
+  // workers keep their own tasks, other threads spread them round-robin
+  const std::size_t index =
+      current_pool == this
+          ? current_index
+          : next_queue_.fetch_add(1u, std::memory_order_relaxed) %
+                queues_.size();
+  {
+    // counted before it is queued so that pending_ never underflows, under
+    // the lock to pair with the predicate check of sleeping workers
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    pending_.fetch_add(1u, std::memory_order_release);
+  }
+  {
+    std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+    queues_[index]->tasks.push_back({std::move(task), group});
+  }
+  wake_.notify_one();
+}
+
+bool ThreadPool::pop(std::size_t index, Task &task, const void *group) {
+  WorkQueue &queue = *queues_[index];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  for (auto it = queue.tasks.rbegin(); it != queue.tasks.rend(); ++it) {
+    if (group != nullptr && it->group != group) continue;
+    task = std::move(*it);
+    queue.tasks.erase(std::next(it).base());
+    pending_.fetch_sub(1u, std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+bool ThreadPool::steal(std::size_t index, Task &task, const void *group) {
+  for (std::size_t k = 1u; k <= queues_.size(); ++k) {
+    WorkQueue &queue = *queues_[(index + k) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    for (auto it = queue.tasks.begin(); it != queue.tasks.end(); ++it) {
+      if (group != nullptr && it->group != group) continue;
+      task = std::move(*it);
+      queue.tasks.erase(it);
+      pending_.fetch_sub(1u, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ThreadPool::runGroupTask(const void *group) {
+  Task task;
+  const bool is_worker = current_pool == this;
+  if ((is_worker && pop(current_index, task, group)) ||
+      steal(is_worker ? current_index : 0u, task, group)) {
+    task.run();
+    return true;
+  }
+  return false;
+}
+
+void ThreadPool::workerLoop(std::size_t index) {
+  current_pool = this;
+  current_index = index;
+
+  while (true) {
+    Task task;
+    if (pop(index, task, nullptr) || steal(index, task, nullptr)) {
+      task.run();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    wake_.wait(lock, [this] {
+      return stop_ || pending_.load(std::memory_order_acquire) > 0u;
+    });
+    if (stop_ && pending_.load(std::memory_order_acquire) == 0u) return;
+  }
+}
+
+}  // namespace path_finding_visualizer